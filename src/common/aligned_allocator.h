@@ -0,0 +1,43 @@
+#ifndef SRC_MODEL_COMMON_ALIGNED_ALLOCATOR_H_
+#define SRC_MODEL_COMMON_ALIGNED_ALLOCATOR_H_
+
+#include <cstddef>
+#include <new>
+
+// Allocator that places container storage on a cache line boundary so that
+// column sweeps start aligned for vector loads.
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+  template <typename U>
+  AlignedAllocator(AlignedAllocator<U, Alignment> const&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+  }
+
+  void deallocate(T* ptr, std::size_t) noexcept {
+    ::operator delete(ptr, std::align_val_t(Alignment));
+  }
+
+  template <typename U>
+  bool operator==(AlignedAllocator<U, Alignment> const&) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(AlignedAllocator<U, Alignment> const&) const noexcept {
+    return false;
+  }
+};
+
+#endif  // SRC_MODEL_COMMON_ALIGNED_ALLOCATOR_H_
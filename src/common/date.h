@@ -0,0 +1,120 @@
+#ifndef SRC_MODEL_COMMON_DATE_H_
+#define SRC_MODEL_COMMON_DATE_H_
+
+#include <cstdint>
+
+// Calendar arithmetic on plain day numbers (days since 1970-01-01, UTC), so
+// hot loops never go through QDate/QDateTime and the time zone database.
+namespace Date {
+
+constexpr int64_t kSecondsPerDay = 86400;
+constexpr int64_t kNanosPerSecond = 1000000000;
+constexpr int64_t kNanosPerMinute = 60 * kNanosPerSecond;
+constexpr int64_t kNanosPerHour = 60 * kNanosPerMinute;
+constexpr int64_t kNanosPerDay = kSecondsPerDay * kNanosPerSecond;
+
+// Proleptic Gregorian date to day number, after H. Hinnant's days_from_civil
+constexpr int64_t DaysFromCivil(int64_t year, unsigned month, unsigned day) {
+  year -= month <= 2;
+  int64_t era = (year >= 0 ? year : year - 399) / 400;
+  unsigned yoe = static_cast<unsigned>(year - era * 400);
+  unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+static_assert(DaysFromCivil(1970, 1, 1) == 0);
+static_assert(DaysFromCivil(2000, 3, 1) == 11017);
+
+constexpr bool IsLeapYear(int64_t year) {
+  return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+// Month 1 to 12
+constexpr unsigned DaysInMonth(int64_t year, unsigned month) {
+  constexpr unsigned kDays[12] = {31, 28, 31, 30, 31, 30,
+                                  31, 31, 30, 31, 30, 31};
+  return month == 2 && IsLeapYear(year) ? 29 : kDays[month - 1];
+}
+
+static_assert(DaysInMonth(2000, 2) == 29 && DaysInMonth(1900, 2) == 28);
+static_assert(DaysInMonth(2024, 2) == 29 && DaysInMonth(2023, 4) == 30);
+
+// Parses a fixed width "yyyy-MM-dd" date. All ten characters are checked at
+// once through a digit mask instead of per-field string conversions.
+constexpr bool ParseIsoDate(const char* str, int64_t& days) {
+  unsigned digits[10] = {};
+  unsigned invalid = 0;
+  for (int i = 0; i < 10; ++i) {
+    digits[i] = static_cast<unsigned char>(str[i]) - '0';
+    invalid |= (i == 4 || i == 7) ? (str[i] != '-') : (digits[i] > 9);
+    if (str[i] == '\0') return false;
+  }
+  if (invalid || (str[10] != '\0' && str[10] != ' ' && str[10] != 'T'))
+    return false;
+
+  int64_t year =
+      digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3];
+  unsigned month = digits[5] * 10 + digits[6];
+  unsigned day = digits[8] * 10 + digits[9];
+  // Out of range days such as 02-30 would roll into the next month
+  if (month < 1 || month > 12 || day < 1 || day > DaysInMonth(year, month))
+    return false;
+
+  days = DaysFromCivil(year, month, day);
+  return true;
+}
+
+constexpr bool ParseTwoDigits(const char* str, unsigned limit,
+                              unsigned& value) {
+  unsigned high = static_cast<unsigned char>(str[0]) - '0';
+  if (high > 9) return false;  // also stops at the terminator
+  unsigned low = static_cast<unsigned char>(str[1]) - '0';
+  if (low > 9) return false;
+  value = high * 10 + low;
+  return value <= limit;
+}
+
+// Parses "yyyy-MM-dd", optionally followed by 'T' or ' ' and a
+// "HH:mm[:ss[.fffffffff]]" time with an optional 'Z', to nanoseconds since
+// the epoch, UTC. Plain dates land on midnight.
+constexpr bool ParseTimestamp(const char* str, int64_t& nanos) {
+  int64_t days = 0;
+  if (!ParseIsoDate(str, days)) return false;
+  nanos = days * kNanosPerDay;
+  if (str[10] == '\0') return true;
+
+  str += 11;
+  unsigned hours = 0, minutes = 0, seconds = 0;
+  if (!ParseTwoDigits(str, 23, hours) || str[2] != ':' ||
+      !ParseTwoDigits(str + 3, 59, minutes))
+    return false;
+  str += 5;
+
+  if (*str == ':') {
+    if (!ParseTwoDigits(str + 1, 60, seconds)) return false;
+    str += 3;
+  }
+
+  int64_t fraction = 0;
+  if (*str == '.') {
+    int64_t scale = kNanosPerSecond;
+    for (++str; '0' <= *str && *str <= '9'; ++str) {
+      if (scale == 1) return false;  // finer than a nanosecond
+      scale /= 10;
+      fraction += (*str - '0') * scale;
+    }
+    if (scale == kNanosPerSecond) return false;
+  }
+
+  if (*str == 'Z') ++str;
+  if (*str != '\0') return false;
+
+  nanos += hours * kNanosPerHour + minutes * kNanosPerMinute +
+           seconds * kNanosPerSecond + fraction;
+  return true;
+}
+
+}  // namespace Date
+
+#endif  // SRC_MODEL_COMMON_DATE_H_
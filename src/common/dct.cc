@@ -0,0 +1,69 @@
+#include "dct.h"
+
+#include <cmath>
+#include <complex>
+#include <utility>
+
+namespace Dct {
+
+namespace {
+
+using Complex = std::complex<double>;
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Iterative radix-2 transform, e^(-2 pi i jk / n)
+void Fft(std::vector<Complex>& data) {
+  std::size_t n = data.size();
+
+  for (std::size_t i = 1, j = 0; i < n; i++) {
+    std::size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(data[i], data[j]);
+  }
+
+  // Twiddles of the full length serve every stage with a stride
+  std::vector<Complex> twiddles(n / 2);
+  for (std::size_t k = 0; k < n / 2; k++)
+    twiddles[k] = std::polar(1.0, -2 * kPi * k / n);
+
+  for (std::size_t len = 2, stride = n / 2; len <= n; len <<= 1, stride >>= 1)
+    for (std::size_t block = 0; block < n; block += len)
+      for (std::size_t k = 0; k < len / 2; k++) {
+        // Spelled out, std::complex multiplication checks for infinities
+        Complex const& twiddle = twiddles[k * stride];
+        Complex& low = data[block + k];
+        Complex& high = data[block + k + len / 2];
+        Complex odd(high.real() * twiddle.real() - high.imag() * twiddle.imag(),
+                    high.real() * twiddle.imag() + high.imag() * twiddle.real());
+        high = low - odd;
+        low += odd;
+      }
+}
+
+}  // namespace
+
+bool Forward(std::vector<double>& data) {
+  std::size_t n = data.size();
+  if (n == 0 || (n & (n - 1))) return false;
+
+  // Even samples in order followed by odd ones reversed turn the DCT into a
+  // plain FFT of the same length (Makhoul)
+  std::vector<Complex> v(n);
+  for (std::size_t j = 0; j < n / 2; j++) {
+    v[j] = data[2 * j];
+    v[n - 1 - j] = data[2 * j + 1];
+  }
+  if (n == 1) v[0] = data[0];
+
+  Fft(v);
+
+  for (std::size_t k = 0; k < n; k++) {
+    double angle = -kPi * k / (2 * n);
+    data[k] = v[k].real() * std::cos(angle) - v[k].imag() * std::sin(angle);
+  }
+  return true;
+}
+
+}  // namespace Dct
@@ -0,0 +1,15 @@
+#ifndef SRC_MODEL_COMMON_DCT_H_
+#define SRC_MODEL_COMMON_DCT_H_
+
+#include <vector>
+
+namespace Dct {
+
+// Replaces data with its DCT-II, X_k = sum(x_j * cos(pi * k * (2j + 1) / 2n)),
+// through one complex FFT of the same length in O(n log n). The size must be
+// a power of two, returns false otherwise.
+bool Forward(std::vector<double>& data);
+
+}  // namespace Dct
+
+#endif  // SRC_MODEL_COMMON_DCT_H_
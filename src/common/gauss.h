@@ -1,6 +1,10 @@
 #ifndef SRC_MODEL_COMMON_GAUSS_H_
 #define SRC_MODEL_COMMON_GAUSS_H_
 
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
 #include <vector>
 
 #include "matrix.h"
@@ -8,6 +12,46 @@
 class Gauss {
  public:
   static std::vector<double> Solve(Matrix& matrix);
+
+  // The same elimination on a fixed size augmented system that lives on the
+  // stack and unrolls. Returns false when the system is singular.
+  template <std::size_t N>
+  static bool Solve(std::array<std::array<double, N + 1>, N>& matrix,
+                    std::array<double, N>& res);
 };
 
+template <std::size_t N>
+bool Gauss::Solve(std::array<std::array<double, N + 1>, N>& matrix,
+                  std::array<double, N>& res) {
+  for (std::size_t k = 0; k < N; k++) {
+    std::size_t index = k;
+    double max = std::abs(matrix[k][k]);
+
+    for (std::size_t i = k + 1; i < N; i++)
+      if (std::abs(matrix[i][k]) > max) {
+        max = std::abs(matrix[i][k]);
+        index = i;
+      }
+
+    if (max == 0) return false;
+
+    std::swap(matrix[k], matrix[index]);
+
+    for (std::size_t i = k; i < N; i++) {
+      double tmp = matrix[i][k];
+      if (tmp == 0) continue;
+      for (std::size_t j = 0; j <= N; j++) matrix[i][j] /= tmp;
+      if (i == k) continue;
+      for (std::size_t j = 0; j <= N; j++) matrix[i][j] -= matrix[k][j];
+    }
+  }
+
+  for (std::size_t i = N; i-- > 0;) {
+    res[i] = matrix[i][N];
+    for (std::size_t j = 0; j < i; j++) matrix[j][N] -= matrix[j][i] * res[i];
+  }
+
+  return true;
+}
+
 #endif  // SRC_MODEL_COMMON_GAUSS_H_
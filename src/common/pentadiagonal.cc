@@ -0,0 +1,38 @@
+#include "pentadiagonal.h"
+
+bool Pentadiagonal::Solve(std::vector<double>& diag,
+                          std::vector<double>& upper1,
+                          std::vector<double>& upper2,
+                          std::vector<double>& rhs) {
+  std::size_t n = diag.size();
+  if (upper1.size() + 1 < n || upper2.size() + 2 < n || rhs.size() != n)
+    return false;
+
+  // diag becomes D, upper1[i] = L(i + 1, i) and upper2[i] = L(i + 2, i)
+  for (std::size_t i = 0; i < n; i++) {
+    double pivot = diag[i];
+    if (i >= 1) pivot -= upper1[i - 1] * upper1[i - 1] * diag[i - 1];
+    if (i >= 2) pivot -= upper2[i - 2] * upper2[i - 2] * diag[i - 2];
+    if (!(pivot > 0)) return false;
+    diag[i] = pivot;
+
+    if (i + 1 < n) {
+      double off = upper1[i];
+      if (i >= 1) off -= upper2[i - 1] * diag[i - 1] * upper1[i - 1];
+      upper1[i] = off / pivot;
+    }
+    if (i + 2 < n) upper2[i] /= pivot;
+  }
+
+  for (std::size_t i = 0; i < n; i++) {
+    if (i >= 1) rhs[i] -= upper1[i - 1] * rhs[i - 1];
+    if (i >= 2) rhs[i] -= upper2[i - 2] * rhs[i - 2];
+  }
+  for (std::size_t i = 0; i < n; i++) rhs[i] /= diag[i];
+  for (std::size_t i = n; i-- > 0;) {
+    if (i + 1 < n) rhs[i] -= upper1[i] * rhs[i + 1];
+    if (i + 2 < n) rhs[i] -= upper2[i] * rhs[i + 2];
+  }
+
+  return true;
+}
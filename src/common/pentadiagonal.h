@@ -0,0 +1,17 @@
+#ifndef SRC_MODEL_COMMON_PENTADIAGONAL_H_
+#define SRC_MODEL_COMMON_PENTADIAGONAL_H_
+
+#include <vector>
+
+// Symmetric positive definite systems with two bands either side of the
+// diagonal, factored as L * D * L^T in O(n) time and no extra memory.
+class Pentadiagonal {
+ public:
+  // diag[i] = A(i, i), upper1[i] = A(i, i + 1), upper2[i] = A(i, i + 2).
+  // The bands are overwritten by the factorization and rhs by the solution.
+  // Returns false when the matrix is not positive definite.
+  static bool Solve(std::vector<double>& diag, std::vector<double>& upper1,
+                    std::vector<double>& upper2, std::vector<double>& rhs);
+};
+
+#endif  // SRC_MODEL_COMMON_PENTADIAGONAL_H_
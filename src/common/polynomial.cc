@@ -0,0 +1,101 @@
+#include "polynomial.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Polynomial {
+
+namespace {
+
+constexpr std::size_t kLanes = 8;
+
+// One Estrin pass over a block of up to kLanes points. terms holds one row
+// of kLanes partial sums per pair of coefficients. With Size != 0 the
+// coefficient count is known at compile time and every trip count is fixed.
+template <std::size_t Size>
+void EstrinBlock(const double* coefs, std::size_t size, const double* x,
+                 std::size_t lanes, double* terms, double* out) {
+  if constexpr (Size != 0) size = Size;
+
+  double power[kLanes] = {};
+  std::copy_n(x, lanes, power);
+
+  std::size_t pairs = (size + 1) / 2;
+  for (std::size_t k = 0; k < pairs; ++k) {
+    double low = coefs[2 * k];
+    double high = 2 * k + 1 < size ? coefs[2 * k + 1] : 0;
+    double* term = terms + k * kLanes;
+    for (std::size_t l = 0; l < kLanes; ++l) term[l] = low + high * power[l];
+  }
+
+  for (std::size_t count = pairs; count > 1; count = (count + 1) / 2) {
+    for (std::size_t l = 0; l < kLanes; ++l) power[l] *= power[l];
+
+    for (std::size_t k = 0; k < count / 2; ++k) {
+      double* term = terms + k * kLanes;
+      const double* low = terms + 2 * k * kLanes;
+      const double* high = terms + (2 * k + 1) * kLanes;
+      for (std::size_t l = 0; l < kLanes; ++l)
+        term[l] = low[l] + high[l] * power[l];
+    }
+
+    // An odd term out moves up unchanged
+    if (count % 2)
+      std::copy_n(terms + (count - 1) * kLanes, kLanes,
+                  terms + count / 2 * kLanes);
+  }
+
+  std::copy_n(terms, lanes, out);
+}
+
+template <std::size_t Size>
+void EvaluateBlocks(const double* coefs, std::size_t size,
+                    Span<const double> x, double* terms, double* out) {
+  for (std::size_t begin = 0; begin < x.size(); begin += kLanes) {
+    std::size_t lanes = std::min(kLanes, x.size() - begin);
+    EstrinBlock<Size>(coefs, size, x.data() + begin, lanes, terms,
+                      out + begin);
+  }
+}
+
+}  // namespace
+
+void Evaluate(Span<const double> coefs, Span<const double> x, double* out) {
+  std::size_t size = coefs.size();
+  if (size <= 2) {
+    for (std::size_t i = 0; i < x.size(); ++i) out[i] = Horner(coefs, x[i]);
+    return;
+  }
+
+  if (Dispatch<kMaxUnrolled>(size, [&](auto fixed) {
+        constexpr std::size_t kSize = decltype(fixed)::value;
+        double terms[(kSize + 1) / 2 * kLanes];
+        EvaluateBlocks<kSize>(coefs.data(), size, x, terms, out);
+      }))
+    return;
+
+  std::vector<double> terms((size + 1) / 2 * kLanes);
+  EvaluateBlocks<0>(coefs.data(), size, x, terms.data(), out);
+}
+
+void EvaluateChebyshev(Span<const double> coefs, Span<const double> t,
+                       double* out) {
+  std::size_t size = coefs.size();
+  for (std::size_t begin = 0; begin < t.size(); begin += kLanes) {
+    std::size_t lanes = std::min(kLanes, t.size() - begin);
+    double point[kLanes] = {}, next[kLanes] = {}, after[kLanes] = {};
+    std::copy_n(t.data() + begin, lanes, point);
+
+    for (std::size_t i = size; i-- > 1;)
+      for (std::size_t l = 0; l < kLanes; ++l) {
+        double current = coefs[i] + 2 * point[l] * next[l] - after[l];
+        after[l] = next[l];
+        next[l] = current;
+      }
+
+    for (std::size_t l = 0; l < lanes; ++l)
+      out[begin + l] = size ? coefs[0] + point[l] * next[l] - after[l] : 0;
+  }
+}
+
+}  // namespace Polynomial
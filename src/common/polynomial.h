@@ -0,0 +1,123 @@
+#ifndef SRC_MODEL_COMMON_POLYNOMIAL_H_
+#define SRC_MODEL_COMMON_POLYNOMIAL_H_
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "span.h"
+
+// Evaluation kernels for polynomials stored lowest power first. Every point
+// costs one multiply-add per coefficient instead of a pow() call per term.
+namespace Polynomial {
+
+// Largest coefficient count (degree 8) with fully unrolled kernels
+constexpr std::size_t kMaxUnrolled = 9;
+
+namespace detail {
+
+template <typename Func, std::size_t... I>
+bool Dispatch(std::size_t size, Func& func, std::index_sequence<I...>) {
+  return ((size == I + 1 &&
+           (func(std::integral_constant<std::size_t, I + 1>()), true)) ||
+          ...);
+}
+
+template <typename T, std::size_t... I>
+T Horner(const T* coefs, double x, std::index_sequence<I...>) {
+  T res = 0;
+  ((res = res * x + coefs[sizeof...(I) - 1 - I]), ...);
+  return res;
+}
+
+template <typename T, std::size_t... I>
+T NewtonForm(const T* coefs, const double* nodes, double x,
+             std::index_sequence<I...>) {
+  constexpr std::size_t kLast = sizeof...(I) - 1;
+  T res = 0;
+  ((res = res * (x - nodes[kLast - I]) + coefs[kLast - I]), ...);
+  return res;
+}
+
+}  // namespace detail
+
+// Calls func(std::integral_constant<std::size_t, size>()) when size is in
+// [1, Max], so the callee can be instantiated for a compile-time size.
+// Returns false without calling func for any other size.
+template <std::size_t Max, typename Func>
+bool Dispatch(std::size_t size, Func&& func) {
+  return detail::Dispatch(size, func, std::make_index_sequence<Max>());
+}
+
+// Horner's rule unrolled for a compile-time coefficient count
+template <std::size_t Size, typename T>
+T FixedHorner(const T* coefs, double x) {
+  return detail::Horner(coefs, x, std::make_index_sequence<Size>());
+}
+
+// Horner's rule, the shortest operation count for a single point. Small
+// sizes go through the unrolled kernel, which performs the same operations.
+template <typename T>
+T Horner(const T* coefs, std::size_t size, double x) {
+  T res = 0;
+  if (Dispatch<kMaxUnrolled>(size, [&](auto fixed) {
+        res = FixedHorner<decltype(fixed)::value>(coefs, x);
+      }))
+    return res;
+
+  for (std::size_t i = size; i-- > 0;) res = res * x + coefs[i];
+  return res;
+}
+
+inline double Horner(Span<const double> coefs, double x) {
+  return Horner(coefs.data(), coefs.size(), x);
+}
+
+// Nested form of a Newton polynomial c0 + (x - x0) * (c1 + (x - x1) * ...),
+// nodes holds at least size - 1 interpolation points
+template <std::size_t Size, typename T>
+T FixedNewtonForm(const T* coefs, const double* nodes, double x) {
+  return detail::NewtonForm(coefs, nodes, x, std::make_index_sequence<Size>());
+}
+
+template <typename T>
+T NewtonForm(const T* coefs, const double* nodes, std::size_t size,
+             double x) {
+  T res = 0;
+  if (Dispatch<kMaxUnrolled>(size, [&](auto fixed) {
+        res = FixedNewtonForm<decltype(fixed)::value>(coefs, nodes, x);
+      }))
+    return res;
+
+  for (std::size_t i = size; i-- > 0;) res = res * (x - nodes[i]) + coefs[i];
+  return res;
+}
+
+// Chebyshev series c0 * T0(t) + c1 * T1(t) + ... by Clenshaw's recurrence,
+// the stable counterpart of Horner's rule for that basis, t in [-1, 1]
+template <typename T>
+T Clenshaw(const T* coefs, std::size_t size, double t) {
+  T next = 0, after = 0;
+  for (std::size_t i = size; i-- > 1;) {
+    T current = coefs[i] + 2 * t * next - after;
+    after = next;
+    next = current;
+  }
+  return size ? coefs[0] + t * next - after : T(0);
+}
+
+// Evaluates at every x into out. Points are taken in fixed width lanes and
+// each lane runs Estrin's scheme, pairing terms by powers x, x^2, x^4, ...,
+// which breaks Horner's serial dependency chain; the inner loops run across
+// lanes so the compiler vectorizes them. Small sizes keep their partial
+// sums in a stack array with compile-time trip counts.
+void Evaluate(Span<const double> coefs, Span<const double> x, double* out);
+
+// Clenshaw at every t into out, lanes of points advance the recurrence
+// together so the inner loop vectorizes
+void EvaluateChebyshev(Span<const double> coefs, Span<const double> t,
+                       double* out);
+
+}  // namespace Polynomial
+
+#endif  // SRC_MODEL_COMMON_POLYNOMIAL_H_
@@ -0,0 +1,43 @@
+#ifndef SRC_MODEL_COMMON_SPAN_H_
+#define SRC_MODEL_COMMON_SPAN_H_
+
+#include <cstddef>
+#include <type_traits>
+
+// Non-owning view over a contiguous range, a C++17 stand-in for std::span.
+template <typename T>
+class Span {
+ public:
+  using value_type = std::remove_cv_t<T>;
+  using iterator = T*;
+
+  Span() = default;
+  Span(T* data, std::size_t size) : data_(data), size_(size) {}
+
+  template <typename Container,
+            typename = decltype(std::declval<Container&>().data()),
+            typename = decltype(std::declval<Container&>().size())>
+  Span(Container& container)  // NOLINT(runtime/explicit)
+      : data_(container.data()), size_(container.size()) {}
+
+  T* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  iterator begin() const { return data_; }
+  iterator end() const { return data_ + size_; }
+
+  T& operator[](std::size_t i) const { return data_[i]; }
+  T& front() const { return data_[0]; }
+  T& back() const { return data_[size_ - 1]; }
+
+  Span Subspan(std::size_t offset, std::size_t count) const {
+    return {data_ + offset, count};
+  }
+
+ private:
+  T* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+#endif  // SRC_MODEL_COMMON_SPAN_H_
@@ -12,6 +12,10 @@ class Timer {
     return duration_cast<milliseconds>(GetTime() - timestamp_);
   }
 
+  double FinishSeconds() {
+    return duration<double>(GetTime() - timestamp_).count();
+  }
+
  private:
   using Timestamp = high_resolution_clock::time_point;
 
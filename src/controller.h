@@ -12,10 +12,12 @@ class Controller {
   Controller &operator=(Controller &&) = delete;
   Controller &operator=(const Controller &) = delete;
 
-  [[nodiscard]] Model::GraphData OpenFile(QString const &filename) {
+  [[nodiscard]] PriceSeries const &OpenFile(QString const &filename) {
     return model_->OpenFile(filename);
   }
 
+  void SetResolution(int64_t resolution) { model_->SetResolution(resolution); }
+
   [[nodiscard]] Model::GraphData Newton(size_t points, size_t degree) const {
     return model_->Newton(points, degree);
   }
@@ -24,12 +26,57 @@ class Controller {
     return model_->Spline(points);
   }
 
+  [[nodiscard]] Model::GraphData Barycentric(size_t points,
+                                             size_t degree) const {
+    return model_->Barycentric(points, degree);
+  }
+
+  [[nodiscard]] Model::GraphData Pchip(size_t points) const {
+    return model_->Pchip(points);
+  }
+
+  [[nodiscard]] Model::GraphData Akima(size_t points) const {
+    return model_->Akima(points);
+  }
+
   [[nodiscard]] Model::GraphData Approximate(size_t points,
                                              size_t degree,  //
                                              size_t days) const {
     return model_->Approximate(points, degree, days);
   }
 
+  [[nodiscard]] Model::GraphData Smooth(size_t points, double lambda) const {
+    return model_->Smooth(points, lambda);
+  }
+
+  [[nodiscard]] Model::GraphData Chebyshev(size_t points,
+                                           size_t degree,  //
+                                           size_t days) const {
+    return model_->Chebyshev(points, degree, days);
+  }
+
+  [[nodiscard]] Model::Curves CalcIndicators(
+      std::vector<Indicators::Spec> const &specs) const {
+    return model_->CalcIndicators(specs);
+  }
+
+  [[nodiscard]] Model::BacktestData RunBacktest(
+      Backtest::Params const &params) const {
+    return model_->RunBacktest(params);
+  }
+
+  [[nodiscard]] std::vector<Backtest::Stats> SweepBacktest(
+      std::vector<Backtest::Params> const &params) const {
+    return model_->SweepBacktest(params);
+  }
+
+  [[nodiscard]] Model::GraphData ApproximateFile(QString const &filename,
+                                                 size_t points,
+                                                 size_t degree,  //
+                                                 size_t days) const {
+    return model_->ApproximateFile(filename, points, degree, days);
+  }
+
   [[nodiscard]] std::tuple<double, double>  //
   FindInterpolationValue(double x, int degree) const {
     return model_->FindInterpolationValue(x, degree);
@@ -50,6 +97,64 @@ class Controller {
     return model_->ApproximationResearch(points, days);
   }
 
+  void Export(QString const &filename, Model::Curves const &curves,
+              size_t max_degree) const {
+    model_->Export(filename, curves, max_degree);
+  }
+
+  [[nodiscard]] Portfolio const &OpenFiles(QString const &pattern) {
+    return model_->OpenFiles(pattern);
+  }
+
+  [[nodiscard]] Model::PortfolioData PortfolioNewton(size_t points,
+                                                     size_t degree) const {
+    return model_->PortfolioNewton(points, degree);
+  }
+
+  [[nodiscard]] Model::PortfolioData PortfolioSpline(size_t points) const {
+    return model_->PortfolioSpline(points);
+  }
+
+  [[nodiscard]] Model::PortfolioData PortfolioBarycentric(size_t points,
+                                                          size_t degree) const {
+    return model_->PortfolioBarycentric(points, degree);
+  }
+
+  [[nodiscard]] Model::PortfolioData PortfolioPchip(size_t points) const {
+    return model_->PortfolioPchip(points);
+  }
+
+  [[nodiscard]] Model::PortfolioData PortfolioAkima(size_t points) const {
+    return model_->PortfolioAkima(points);
+  }
+
+  [[nodiscard]] Model::PortfolioData PortfolioApproximate(size_t points,
+                                                          size_t degree,  //
+                                                          size_t days) const {
+    return model_->PortfolioApproximate(points, degree, days);
+  }
+
+  [[nodiscard]] Model::PortfolioData PortfolioSmooth(size_t points,
+                                                     double lambda) const {
+    return model_->PortfolioSmooth(points, lambda);
+  }
+
+  [[nodiscard]] Model::PortfolioData PortfolioChebyshev(size_t points,
+                                                        size_t degree,  //
+                                                        size_t days) const {
+    return model_->PortfolioChebyshev(points, degree, days);
+  }
+
+  [[nodiscard]] std::vector<std::pair<std::string, Model::Curves>>  //
+  PortfolioIndicators(std::vector<Indicators::Spec> const &specs) const {
+    return model_->PortfolioIndicators(specs);
+  }
+
+  [[nodiscard]] std::vector<std::pair<std::string, Backtest::Stats>>  //
+  PortfolioBacktest(Backtest::Params const &params) const {
+    return model_->PortfolioBacktest(params);
+  }
+
  private:
   Model *model_;
 };
@@ -0,0 +1,145 @@
+#include "barycentric.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Interpolation {
+
+namespace {
+
+constexpr std::size_t kLanes = 8;
+
+}  // namespace
+
+Barycentric::Barycentric(Span<const double> x,  //
+                         Span<const double> y,  //
+                         std::size_t degree) {
+  if (x.size() != y.size() || x.size() < 2 || degree == 0) return;
+
+  std::size_t polinoms = (x.size() - 1) / degree;
+  knots_.assign(x.begin(), x.end());
+  values_.assign(y.begin(), y.end());
+  sorted_ = std::is_sorted(knots_.begin(), knots_.end());
+
+  knot_offsets_.reserve(polinoms);
+  weight_offsets_.reserve(polinoms + 1);
+  weights_.reserve(x.size() + polinoms);
+  weight_offsets_.push_back(0);
+
+  for (std::size_t i = 0, step = degree; i < polinoms; i++) {
+    std::size_t start = i * step;
+    std::size_t end = (i == polinoms - 1) ? x.size() : (i + 1) * step + 1;
+    knot_offsets_.push_back(start);
+
+    // w_j = 1 / prod(x_j - x_m), differences scaled by the segment length
+    // keep the products in range, any common factor cancels out of p(x)
+    const double* k = knots_.data() + start;
+    std::size_t size = end - start;
+    double scale = 4 / (k[size - 1] - k[0]);
+
+    double norm = 0;
+    for (std::size_t j = 0; j < size; j++) {
+      double product = 1;
+      for (std::size_t m = 0; m < size; m++)
+        if (m != j) product *= scale * (k[j] - k[m]);
+      weights_.push_back(1 / product);
+      norm = std::max(norm, std::fabs(weights_.back()));
+    }
+    for (std::size_t j = weight_offsets_.back(); j < weights_.size(); j++)
+      weights_[j] /= norm;
+
+    weight_offsets_.push_back(weights_.size());
+  }
+}
+
+double Barycentric::GetValue(double x) const {
+  std::size_t segment = FindSegment(x);
+  if (segment == Segments()) return 0;
+
+  double res = 0;
+  Evaluate(segment, &x, 1, &res);
+  return res;
+}
+
+void Barycentric::GetValues(Span<const double> x, double* out) const {
+  std::size_t segment = Segments();
+  for (std::size_t i = 0; i < x.size();) {
+    if (!sorted_ || segment == Segments() || !Contains(segment, x[i]))
+      segment = FindSegment(x[i]);
+    if (segment == Segments()) {
+      out[i++] = 0;
+      continue;
+    }
+
+    std::size_t end = i + 1;
+    while (end < x.size() && Contains(segment, x[end])) end++;
+    Evaluate(segment, x.data() + i, end - i, out + i);
+    i = end;
+  }
+}
+
+std::size_t Barycentric::FindSegment(double x) const {
+  std::size_t segments = Segments();
+  if (!sorted_) {
+    for (std::size_t s = 0; s < segments; s++)
+      if (Contains(s, x)) return s;
+    return segments;
+  }
+
+  // First segment whose last knot is not below x, shared knots resolve to
+  // the earlier segment as with a front to back scan
+  std::size_t low = 0, high = segments;
+  while (low < high) {
+    std::size_t mid = (low + high) / 2;
+    std::size_t last = knot_offsets_[mid] + weight_offsets_[mid + 1] -
+                       weight_offsets_[mid] - 1;
+    if (knots_[last] < x)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return low < segments && Contains(low, x) ? low : segments;
+}
+
+bool Barycentric::Contains(std::size_t segment, double x) const {
+  std::size_t first = knot_offsets_[segment];
+  std::size_t last =
+      first + weight_offsets_[segment + 1] - weight_offsets_[segment] - 1;
+  return knots_[first] <= x && x <= knots_[last];
+}
+
+void Barycentric::Evaluate(std::size_t segment, const double* x,
+                           std::size_t size, double* out) const {
+  const double* k = knots_.data() + knot_offsets_[segment];
+  const double* v = values_.data() + knot_offsets_[segment];
+  const double* w = weights_.data() + weight_offsets_[segment];
+  std::size_t count = weight_offsets_[segment + 1] - weight_offsets_[segment];
+
+  // Knots in the outer loop and lanes of points in the inner one, each lane
+  // keeps its own sums so the compiler vectorizes without reassociating
+  for (std::size_t begin = 0; begin < size; begin += kLanes) {
+    std::size_t lanes = std::min(kLanes, size - begin);
+    double point[kLanes], num[kLanes] = {}, den[kLanes] = {};
+    std::fill_n(std::copy_n(x + begin, lanes, point), kLanes - lanes,
+                x[begin]);
+
+    for (std::size_t j = 0; j < count; j++)
+      for (std::size_t l = 0; l < kLanes; l++) {
+        double term = w[j] / (point[l] - k[j]);
+        num[l] += term * v[j];
+        den[l] += term;
+      }
+
+    for (std::size_t l = 0; l < lanes; l++) {
+      out[begin + l] = num[l] / den[l];
+
+      // A point on a knot divides by zero, the formula gives way to y_j
+      if (!std::isfinite(out[begin + l]))
+        for (std::size_t j = 0; j < count; j++)
+          if (point[l] == k[j]) out[begin + l] = v[j];
+    }
+  }
+}
+
+}  // namespace Interpolation
@@ -0,0 +1,50 @@
+#ifndef SRC_MODEL_APPROXIMATION_BARYCENTRIC_H_
+#define SRC_MODEL_APPROXIMATION_BARYCENTRIC_H_
+
+#include <vector>
+
+#include "base_approximation.h"
+#include "span.h"
+
+namespace Interpolation {
+
+// Piecewise Lagrange interpolation in barycentric form over the same runs of
+// degree + 1 knots as Newton. Building a segment computes its weights once
+// in O(k^2), every point then costs O(k) with no nested products:
+//
+//   p(x) = sum(w_j * y_j / (x - x_j)) / sum(w_j / (x - x_j))
+//
+// which stays accurate at degrees where the Newton form loses digits.
+class Barycentric : public BaseApproximation {
+ public:
+  Barycentric(Span<const double> x,  //
+              Span<const double> y,  //
+              std::size_t degree);
+  ~Barycentric() = default;
+  Barycentric(Barycentric&&) = delete;
+  Barycentric(const Barycentric&) = delete;
+  Barycentric& operator=(Barycentric&&) = delete;
+  Barycentric& operator=(const Barycentric&) = delete;
+
+  virtual double GetValue(double x) const override;
+  // Points of one segment are evaluated in lanes so the sums vectorize
+  virtual void GetValues(Span<const double> x, double* out) const override;
+
+  std::size_t Segments() const noexcept { return knot_offsets_.size(); }
+
+ private:
+  std::vector<double> knots_, values_;
+  std::vector<double> weights_;
+  std::vector<std::size_t> knot_offsets_;    // first knot of each segment
+  std::vector<std::size_t> weight_offsets_;  // first weight, plus the end
+  bool sorted_ = true;
+
+  std::size_t FindSegment(double x) const;
+  bool Contains(std::size_t segment, double x) const;
+  void Evaluate(std::size_t segment, const double* x, std::size_t size,
+                double* out) const;
+};
+
+}  // namespace Interpolation
+
+#endif  // SRC_MODEL_APPROXIMATION_BARYCENTRIC_H_
@@ -1,10 +1,17 @@
 #ifndef SRC_MODEL_APPROXIMATION_BASE_APPROXIMATION_H_
 #define SRC_MODEL_APPROXIMATION_BASE_APPROXIMATION_H_
 
+#include "span.h"
+
 class BaseApproximation {
  public:
   virtual ~BaseApproximation() = default;
   virtual double GetValue(double x) const = 0;
+
+  // Evaluates at every x into out, engines with a batch kernel override it
+  virtual void GetValues(Span<const double> x, double* out) const {
+    for (size_t i = 0; i < x.size(); ++i) out[i] = GetValue(x[i]);
+  }
 };
 
 #endif  // SRC_MODEL_APPROXIMATION_BASE_APPROXIMATION_H_
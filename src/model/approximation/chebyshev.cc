@@ -0,0 +1,91 @@
+#include "chebyshev.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "dct.h"
+#include "hermite.h"
+#include "polynomial.h"
+
+namespace Approximation {
+
+namespace {
+
+// Resampling nodes are at least this many times the kept coefficients, so
+// higher terms alias into them as little as possible
+constexpr size_t kOversampling = 4;
+constexpr size_t kMaxNodes = size_t(1) << 20;
+
+constexpr double kPi = 3.14159265358979323846;
+
+}  // namespace
+
+Chebyshev::Chebyshev(Span<const double> x,  //
+                     Span<const double> y,  //
+                     size_t degree) {
+  if (x.size() != y.size() || x.size() < 2) return;
+
+  auto [low, high] = std::minmax_element(x.begin(), x.end());
+  if (!(*low < *high)) return;
+  center_ = (*low + *high) / 2;
+  scale_ = 2 / (*high - *low);
+
+  // A power of two covering every sample, within the DCT's reach
+  size_t want = std::max((degree + 1) * kOversampling, x.size());
+  size_t nodes = 1;
+  while (nodes < want && nodes < kMaxNodes) nodes <<= 1;
+
+  // Nodes t_j = cos(pi * (j + 0.5) / n) run from 1 down to -1, so they are
+  // generated from the far end to evaluate in ascending order
+  std::vector<double> keys(nodes), samples(nodes);
+  for (size_t j = 0; j < nodes; j++)
+    keys[nodes - 1 - j] =
+        center_ + std::cos(kPi * (j + 0.5) / nodes) / scale_;
+
+  // Built on the calling thread, Chebyshev fits run inside portfolio pools
+  Interpolation::Hermite resample(x, y, Interpolation::Hermite::Method::kPchip,
+                                  false);
+  resample.GetValues(keys, samples.data());
+  std::reverse(samples.begin(), samples.end());
+
+  if (!Dct::Forward(samples)) return;
+
+  // c_k = 2 / n * X_k with the constant term halved
+  coefs_.assign(samples.begin(),
+                samples.begin() + std::min(degree + 1, nodes));
+  for (double& coef : coefs_) coef *= 2.0 / nodes;
+  coefs_[0] /= 2;
+
+  // T_k(1) = 1 and T_k(-1) = (-1)^k, so the terms above the extrapolation
+  // degree sum to the gaps at the ends directly
+  for (size_t k = kExtrapolationDegree + 1; k < coefs_.size(); ++k) {
+    upper_shift_ += coefs_[k];
+    lower_shift_ += k % 2 ? -coefs_[k] : coefs_[k];
+  }
+}
+
+double Chebyshev::GetValue(double x) const {
+  double t = (x - center_) * scale_;
+  if (std::fabs(t) > 1) return Extrapolate(t);
+  return Polynomial::Clenshaw(coefs_.data(), coefs_.size(), t);
+}
+
+void Chebyshev::GetValues(Span<const double> x, double* out) const {
+  // Maps into out first, so no scratch buffer is needed. Points past the
+  // range are summed in full too and then overwritten.
+  for (size_t i = 0; i < x.size(); ++i) out[i] = (x[i] - center_) * scale_;
+  Polynomial::EvaluateChebyshev(coefs_, {out, x.size()}, out);
+
+  for (size_t i = 0; i < x.size(); ++i) {
+    double t = (x[i] - center_) * scale_;
+    if (std::fabs(t) > 1) out[i] = Extrapolate(t);
+  }
+}
+
+double Chebyshev::Extrapolate(double t) const {
+  size_t size = std::min(coefs_.size(), kExtrapolationDegree + 1);
+  return Polynomial::Clenshaw(coefs_.data(), size, t) +
+         (t > 0 ? upper_shift_ : lower_shift_);
+}
+
+}  // namespace Approximation
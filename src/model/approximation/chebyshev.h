@@ -0,0 +1,51 @@
+#ifndef SRC_MODEL_APPROXIMATION_CHEBYSHEV_H_
+#define SRC_MODEL_APPROXIMATION_CHEBYSHEV_H_
+
+#include <vector>
+
+#include "base_approximation.h"
+#include "span.h"
+
+namespace Approximation {
+
+// Truncated Chebyshev series over the range of x. The data is resampled by
+// PCHIP on Chebyshev nodes, the coefficients of all nodes come from one
+// DCT in O(n log n) and the first degree + 1 are kept. Chebyshev
+// polynomials are orthogonal on the range, so no normal equations are
+// formed and degrees far beyond what LeastSquares survives stay well
+// conditioned. Values are summed by Clenshaw's recurrence.
+//
+// Past the range T_n(t) grows like cosh(n acosh t), so the high terms, fitted
+// to noise, would swamp any forecast. There only the terms up to
+// kExtrapolationDegree are summed, shifted to meet the full series at the
+// end of the range.
+class Chebyshev : public BaseApproximation {
+ public:
+  static constexpr size_t kExtrapolationDegree = 3;
+
+  Chebyshev(Span<const double> x,  //
+            Span<const double> y,  //
+            size_t degree);
+  ~Chebyshev() = default;
+  Chebyshev(Chebyshev&&) = delete;
+  Chebyshev(const Chebyshev&) = delete;
+  Chebyshev& operator=(Chebyshev&&) = delete;
+  Chebyshev& operator=(const Chebyshev&) = delete;
+
+  double GetValue(double x) const override;
+  void GetValues(Span<const double> x, double* out) const override;
+
+  // T0 first, in terms of t = (2x - a - b) / (b - a); empty if the fit failed
+  std::vector<double> const& Coefs() const noexcept { return coefs_; }
+
+ private:
+  std::vector<double> coefs_;
+  double center_ = 0, scale_ = 0;  // t = (x - center) * scale
+  double lower_shift_ = 0, upper_shift_ = 0;  // full minus low degree at ends
+
+  double Extrapolate(double t) const;
+};
+
+}  // namespace Approximation
+
+#endif  // SRC_MODEL_APPROXIMATION_CHEBYSHEV_H_
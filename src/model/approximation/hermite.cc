@@ -0,0 +1,121 @@
+#include "hermite.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace Interpolation {
+
+namespace {
+
+// Segments per task, below two chunks the build stays on the calling thread
+constexpr std::size_t kChunk = 1 << 16;
+
+}  // namespace
+
+// Knot slopes for one method, read only so chunks can share it
+class Hermite::Slopes {
+ public:
+  Slopes(Span<const double> x, Span<const double> y, Method method)
+      : x_(x), y_(y), method_(method), last_(x.size() - 1) {}
+
+  // Secant of interval k, [x_k, x_k+1]
+  double Secant(std::ptrdiff_t k) const {
+    return (y_[k + 1] - y_[k]) / (x_[k + 1] - x_[k]);
+  }
+
+  double operator()(std::size_t k) const {
+    if (last_ == 1) return Secant(0);
+    return method_ == Method::kPchip ? Pchip(k) : Akima(k);
+  }
+
+ private:
+  Span<const double> x_, y_;
+  Method method_;
+  std::size_t last_;
+
+  double Width(std::size_t k) const { return x_[k + 1] - x_[k]; }
+
+  double Pchip(std::size_t k) const {
+    if (k == 0) return PchipEnd(Width(0), Width(1), Secant(0), Secant(1));
+    if (k == last_)
+      return PchipEnd(Width(k - 1), Width(k - 2), Secant(k - 1),
+                      Secant(k - 2));
+
+    // Weighted harmonic mean of the secants, flat at a local extremum
+    double left = Secant(k - 1), right = Secant(k);
+    if (left * right <= 0) return 0;
+
+    double h0 = Width(k - 1), h1 = Width(k);
+    double w0 = 2 * h1 + h0, w1 = h1 + 2 * h0;
+    return (w0 + w1) / (w0 / left + w1 / right);
+  }
+
+  // One sided three point estimate, limited to keep the end monotone
+  static double PchipEnd(double h0, double h1, double m0, double m1) {
+    double slope = ((2 * h0 + h1) * m0 - h0 * m1) / (h0 + h1);
+    if (slope * m0 <= 0) return 0;
+    if (m0 * m1 < 0 && std::fabs(slope) > 3 * std::fabs(m0)) return 3 * m0;
+    return slope;
+  }
+
+  double Akima(std::size_t k) const {
+    std::ptrdiff_t i = k;
+    double m0 = Extended(i - 2), m1 = Extended(i - 1);
+    double m2 = Extended(i), m3 = Extended(i + 1);
+
+    double w0 = std::fabs(m3 - m2), w1 = std::fabs(m1 - m0);
+    if (w0 + w1 == 0) return (m1 + m2) / 2;
+    return (w0 * m1 + w1 * m2) / (w0 + w1);
+  }
+
+  // Secants continued linearly by two intervals past either end
+  double Extended(std::ptrdiff_t k) const {
+    std::ptrdiff_t intervals = last_;
+    if (k < 0) return (1 - k) * Secant(0) + k * Secant(1);
+    if (k >= intervals) {
+      std::ptrdiff_t past = k - intervals + 1;
+      return (1 + past) * Secant(intervals - 1) - past * Secant(intervals - 2);
+    }
+    return Secant(k);
+  }
+};
+
+Hermite::Hermite(Span<const double> x, Span<const double> y, Method method,
+                 bool parallel) {
+  if (x.size() != y.size() || x.size() < 2) return;
+
+  Slopes slopes(x, y, method);
+  std::vector<Segment> segments(x.size() - 1);
+
+  // Each chunk works out the slopes at its own end knots, so chunks touch
+  // disjoint records and the result does not depend on how work is split
+  auto build = [&](std::size_t begin, std::size_t end) {
+    double left = slopes(begin);
+    for (std::size_t k = begin; k < end; k++) {
+      double right = slopes(k + 1);
+      double h = x[k + 1] - x[k], secant = slopes.Secant(k);
+      segments[k] = {x[k], (left + right - 2 * secant) / (h * h),
+                     (3 * secant - 2 * left - right) / h, left, y[k]};
+      left = right;
+    }
+  };
+
+  std::size_t size = segments.size();
+  if (!parallel || size < 2 * kChunk) {
+    build(0, size);
+  } else {
+    ThreadPool pool;
+    for (std::size_t begin = 0; begin < size; begin += kChunk)
+      pool.AddTask(
+          [&, begin] { build(begin, std::min(size, begin + kChunk)); });
+    pool.WaitAll();
+  }
+
+  Adopt(std::move(segments), x);
+}
+
+}  // namespace Interpolation
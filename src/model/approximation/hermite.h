@@ -0,0 +1,36 @@
+#ifndef SRC_MODEL_APPROXIMATION_HERMITE_H_
+#define SRC_MODEL_APPROXIMATION_HERMITE_H_
+
+#include "piecewise_cubic.h"
+#include "span.h"
+
+namespace Interpolation {
+
+// Local cubic Hermite interpolation. The slope at each knot comes from the
+// secants around it only, so there is no system to solve and every segment
+// is built independently; long series are built in chunks on a ThreadPool
+// unless parallel is false, for callers already running on a pool.
+//
+//   kPchip  Fritsch-Carlson slopes, monotone between monotone data, never
+//           overshoots a gap
+//   kAkima  Akima slopes, follows the data closely while damping the
+//           wiggles a single outlier causes in a spline
+class Hermite : public PiecewiseCubic<double> {
+ public:
+  enum class Method { kPchip, kAkima };
+
+  Hermite(Span<const double> x, Span<const double> y, Method method,
+          bool parallel = true);
+  ~Hermite() = default;
+  Hermite(Hermite &&) = delete;
+  Hermite(const Hermite &) = delete;
+  Hermite &operator=(Hermite &&) = delete;
+  Hermite &operator=(const Hermite &) = delete;
+
+ private:
+  class Slopes;
+};
+
+}  // namespace Interpolation
+
+#endif  // SRC_MODEL_APPROXIMATION_HERMITE_H_
@@ -2,49 +2,35 @@
 
 #include <utility>
 
-#include "gauss.h"
+#include "polynomial.h"
+#include "power_sums.h"
 
 namespace Approximation {
-LeastSquares::LeastSquares(const std::vector<double> &x,  //
-                           const std::vector<double> &y,  //
-                           const std::vector<double> &w,  //
+LeastSquares::LeastSquares(Span<const double> x,  //
+                           Span<const double> y,  //
+                           Span<const double> w,  //
                            size_t degree) {
   if (x.size() != y.size() || x.size() != w.size() || x.empty() || degree == 0)
     return;
 
-  x_ = x, y_ = y, w_ = w;
+  x_.assign(x.begin(), x.end());
+  y_.assign(y.begin(), y.end());
+  w_.assign(w.begin(), w.end());
   coefs_ = CalcCoef(degree);
 }
 
 double LeastSquares::GetValue(double x) const {
-  double res = 0;
-  for (size_t i = 0; i < coefs_.size(); i++) res += coefs_[i] * pow(x, i);
-  return res;
+  return Polynomial::Horner(coefs_, x);
 };
 
-std::vector<double> LeastSquares::CalcCoef(size_t degree) {
-  Matrix matrix(degree + 1, degree + 2);
-  for (int i = 0; i < matrix.Rows(); ++i)
-    for (int j = 0; j < matrix.Rows(); ++j)  //
-      matrix(i, j) = CalcSumX(i + j);
-
-  for (int i = 0; i < matrix.Rows(); ++i)
-    matrix(i, matrix.Cols() - 1) = CalcSumY(i);
-
-  return Gauss::Solve(matrix);
+void LeastSquares::GetValues(Span<const double> x, double* out) const {
+  Polynomial::Evaluate(coefs_, x, out);
 }
 
-double LeastSquares::CalcSumX(size_t power) const {
-  double res = 0;
-  for (size_t i = 0; i < x_.size(); i++) res += w_.at(i) * pow(x_.at(i), power);
-  return res;
-}
-
-double LeastSquares::CalcSumY(size_t power) const {
-  double res = 0;
-  for (size_t i = 0; i < x_.size(); i++)
-    res += w_.at(i) * y_.at(i) * pow(x_.at(i), power);
-  return res;
+std::vector<double> LeastSquares::CalcCoef(size_t degree) {
+  PowerSums sums(degree);
+  sums.Add(x_, y_, w_);
+  return sums.Solve();
 }
 
 std::vector<double> LeastSquares::FindReverseSlopeWeights() {
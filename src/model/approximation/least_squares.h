@@ -5,14 +5,15 @@
 #include <vector>
 
 #include "base_approximation.h"
+#include "span.h"
 
 namespace Approximation {
 
 class LeastSquares : public BaseApproximation {
  public:
-  LeastSquares(const std::vector<double>& x,  //
-               const std::vector<double>& y,  //
-               const std::vector<double>& w,  //
+  LeastSquares(Span<const double> x,  //
+               Span<const double> y,  //
+               Span<const double> w,  //
                size_t degree);
   ~LeastSquares() = default;
   LeastSquares(LeastSquares&&) = delete;
@@ -21,15 +22,17 @@ class LeastSquares : public BaseApproximation {
   LeastSquares& operator=(const LeastSquares&) = delete;
 
   double GetValue(double x) const override;
+  void GetValues(Span<const double> x, double* out) const override;
   std::vector<double> FindReverseSlopeWeights();
 
+  // From the lowest power up, empty if the fit failed
+  std::vector<double> const& Coefs() const noexcept { return coefs_; }
+
  private:
   std::vector<double> coefs_;
   std::vector<double> x_, y_, w_;
 
   std::vector<double> CalcCoef(size_t degree);
-  double CalcSumX(size_t power) const;
-  double CalcSumY(size_t power) const;
 };
 
 }  // namespace Approximation
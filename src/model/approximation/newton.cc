@@ -2,81 +2,94 @@
 
 #include <algorithm>
 
+#include "polynomial.h"
+
 namespace Interpolation {
 
-Newton::Newton(std::vector<double> const& x,  //
-               std::vector<double> const& y,  //
+Newton::Newton(Span<const double> x,  //
+               Span<const double> y,  //
                std::size_t degree) {
-  if (x.size() != y.size() || x.size() < 2) return;
+  if (x.size() != y.size() || x.size() < 2 || degree == 0) return;
 
   std::size_t polinoms = (x.size() - 1) / degree;
-  newtons_.clear();
-  newtons_.reserve(polinoms);
+  knots_.assign(x.begin(), x.end());
+  sorted_ = std::is_sorted(knots_.begin(), knots_.end());
+
+  knot_offsets_.reserve(polinoms);
+  coef_offsets_.reserve(polinoms + 1);
+  coefs_.reserve(x.size() + polinoms);
+  coef_offsets_.push_back(0);
 
   for (std::size_t i = 0, step = degree; i < polinoms; i++) {
-    int start = i * step;
-    int end = (i == polinoms - 1) ? x.size() : (i + 1) * step + 1;
+    std::size_t start = i * step;
+    std::size_t end = (i == polinoms - 1) ? x.size() : (i + 1) * step + 1;
+    knot_offsets_.push_back(start);
+
+    // Divided differences in place, c[j] ends up as f[x0, ..., xj]
+    coefs_.insert(coefs_.end(), y.begin() + start, y.begin() + end);
+    long double* c = coefs_.data() + coef_offsets_.back();
+    const double* k = knots_.data() + start;
+
+    std::size_t size = end - start;
+    for (std::size_t j = 1; j < size; j++)
+      for (std::size_t m = size - 1; m >= j; m--)
+        c[m] = (c[m] - c[m - 1]) / (k[m] - k[m - j]);
 
-    newtons_.push_back({{x.begin() + start, x.begin() + end},
-                        {y.begin() + start, y.begin() + end}});
+    coef_offsets_.push_back(coefs_.size());
   }
 }
 
 double Newton::GetValue(double x) const {
-  auto itr = std::find_if(newtons_.begin(), newtons_.end(),
-                          [&](auto& newton) { return newton.IsBelongX(x); });
-
-  if (itr == newtons_.end()) return 0;
-  return itr->GetValue(x);
+  std::size_t segment = FindSegment(x);
+  if (segment == Segments()) return 0;
+  return Evaluate(segment, x);
 }
 
-Newton::MiniNewton::MiniNewton(std::vector<double>&& x,
-                               std::vector<double>&& y) {
-  if (x.size() != y.size() || x.size() < 2) return;
-  x_ = std::move(x), y_ = std::move(y);
-
-  coefs_.reserve(x_.size());
-  coefs_.push_back(y_.at(0));
-
-  for (std::size_t i = 1; i < x_.size(); i++) {
-    double res = (y_.at(i) - GetSumP(i)) / GetP(i, i);
-    coefs_.push_back(res);
+void Newton::GetValues(Span<const double> x, double* out) const {
+  std::size_t segment = 0;
+  for (std::size_t i = 0; i < x.size(); i++) {
+    if (!sorted_ || segment == Segments() || !Contains(segment, x[i]))
+      segment = FindSegment(x[i]);
+    out[i] = segment == Segments() ? 0 : Evaluate(segment, x[i]);
   }
 }
 
-long double Newton::MiniNewton::GetSumP(std::size_t ind) const {
-  long double res = 0;
-  for (std::size_t i = 0; i < coefs_.size(); i++)
-    res += coefs_[i] * GetP(i, ind);
-  return res;
-}
-
-long double Newton::MiniNewton::GetP(std::size_t until, std::size_t ind) const {
-  long double res = 1;
-  for (std::size_t i = 0; i < until; i++) res *= x_.at(ind) - x_.at(i);
-  return res;
-}
+std::size_t Newton::FindSegment(double x) const {
+  std::size_t segments = Segments();
+  if (!sorted_) {
+    for (std::size_t s = 0; s < segments; s++)
+      if (Contains(s, x)) return s;
+    return segments;
+  }
 
-long double Newton::MiniNewton::GetFreeP(std::size_t ind, double x) const {
-  long double res = 1;
-  for (std::size_t i = 0; i < ind; i++) res *= x - x_.at(i);
-  return res;
-}
+  // First segment whose last knot is not below x, shared knots resolve to
+  // the earlier segment as with a front to back scan
+  std::size_t low = 0, high = segments;
+  while (low < high) {
+    std::size_t mid = (low + high) / 2;
+    std::size_t last = knot_offsets_[mid] + coef_offsets_[mid + 1] -
+                       coef_offsets_[mid] - 1;
+    if (knots_[last] < x)
+      low = mid + 1;
+    else
+      high = mid;
+  }
 
-long double Newton::MiniNewton::GetFreeSumP(double x) const {
-  long double res = 0;
-  for (std::size_t i = 0; i < coefs_.size(); i++)
-    res += coefs_[i] * GetFreeP(i, x);
-  return res;
+  return low < segments && Contains(low, x) ? low : segments;
 }
 
-double Newton::MiniNewton::GetValue(double x) const {
-  return static_cast<double>(GetFreeSumP(x));
+bool Newton::Contains(std::size_t segment, double x) const {
+  std::size_t first = knot_offsets_[segment];
+  std::size_t last =
+      first + coef_offsets_[segment + 1] - coef_offsets_[segment] - 1;
+  return knots_[first] <= x && x <= knots_[last];
 }
 
-bool Newton::MiniNewton::IsBelongX(double x) const {
-  if (x_.empty()) return false;
-  return x_.front() <= x && x <= x_.back();
+double Newton::Evaluate(std::size_t segment, double x) const {
+  std::size_t offset = coef_offsets_[segment];
+  return static_cast<double>(Polynomial::NewtonForm(
+      coefs_.data() + offset, knots_.data() + knot_offsets_[segment],
+      coef_offsets_[segment + 1] - offset, x));
 }
 
 }  // namespace Interpolation
@@ -4,13 +4,18 @@
 #include <vector>
 
 #include "base_approximation.h"
+#include "span.h"
 
 namespace Interpolation {
 
+// Piecewise Newton interpolation, one polynomial per run of degree + 1
+// knots. All segments live in flat arrays: the knots once, neighbours
+// sharing their boundary knot, and the coefficients back to back, so a
+// fit costs a handful of allocations however many segments there are.
 class Newton : public BaseApproximation {
  public:
-  Newton(std::vector<double> const& x,  //
-         std::vector<double> const& y,  //
+  Newton(Span<const double> x,  //
+         Span<const double> y,  //
          std::size_t degree);
   ~Newton() = default;
   Newton(Newton&&) = delete;
@@ -19,34 +24,21 @@ class Newton : public BaseApproximation {
   Newton& operator=(const Newton&) = delete;
 
   virtual double GetValue(double x) const override;
+  // Ascending x walk the segments forward instead of searching each time
+  virtual void GetValues(Span<const double> x, double* out) const override;
 
- private:
-  class MiniNewton;
-
-  std::vector<MiniNewton> newtons_;
-};
-
-class Newton::MiniNewton {
- public:
-  MiniNewton(std::vector<double>&& x,  //
-             std::vector<double>&& y);
-  ~MiniNewton() = default;
-  MiniNewton(MiniNewton&&) = default;
-  MiniNewton(const MiniNewton&) = default;
-  MiniNewton& operator=(MiniNewton&&) = default;
-  MiniNewton& operator=(const MiniNewton&) = default;
-
-  double GetValue(double x) const;
-  bool IsBelongX(double x) const;
+  std::size_t Segments() const noexcept { return knot_offsets_.size(); }
 
  private:
+  std::vector<double> knots_;
   std::vector<long double> coefs_;
-  std::vector<double> x_, y_;
+  std::vector<std::size_t> knot_offsets_;  // first knot of each segment
+  std::vector<std::size_t> coef_offsets_;  // first coefficient, plus the end
+  bool sorted_ = true;
 
-  long double GetSumP(std::size_t ind) const;
-  long double GetP(std::size_t until, std::size_t ind) const;
-  long double GetFreeSumP(double x) const;
-  long double GetFreeP(std::size_t ind, double xp) const;
+  std::size_t FindSegment(double x) const;
+  bool Contains(std::size_t segment, double x) const;
+  double Evaluate(std::size_t segment, double x) const;
 };
 
 }  // namespace Interpolation
@@ -0,0 +1,81 @@
+#include "piecewise_cubic.h"
+
+#include <algorithm>
+
+namespace Interpolation {
+
+template <typename Coef>
+void PiecewiseCubic<Coef>::Adopt(std::vector<Segment> &&segments,
+                                 Span<const double> x) {
+  segments_ = std::move(segments);
+  last_ = x.empty() ? 0 : x.back();
+  sorted_ = std::is_sorted(x.begin(), x.end());
+}
+
+template <typename Coef>
+double PiecewiseCubic<Coef>::GetValue(double x) const {
+  std::size_t segment = FindSegment(x);
+  if (segment == segments_.size()) return 0;
+  return Evaluate(segment, x);
+}
+
+template <typename Coef>
+void PiecewiseCubic<Coef>::GetValues(Span<const double> x,
+                                     double *out) const {
+  std::size_t segment = 0;
+  for (std::size_t i = 0; i < x.size(); i++) {
+    // Points spaced about as widely as the knots mostly step to the next one
+    if (sorted_ && segment + 1 < segments_.size() && !Contains(segment, x[i]) &&
+        Contains(segment + 1, x[i]))
+      segment++;
+    if (!sorted_ || segment == segments_.size() || !Contains(segment, x[i]))
+      segment = FindSegment(x[i]);
+    out[i] = segment == segments_.size() ? 0 : Evaluate(segment, x[i]);
+  }
+}
+
+template <typename Coef>
+std::size_t PiecewiseCubic<Coef>::FindSegment(double x) const {
+  std::size_t segments = segments_.size();
+  if (!sorted_) {
+    for (std::size_t s = 0; s < segments; s++)
+      if (Contains(s, x)) return s;
+    return segments;
+  }
+
+  // First segment whose right knot is not below x, a shared knot belongs to
+  // the earlier segment as with a front to back scan
+  std::size_t low = 0, high = segments;
+  while (low < high) {
+    std::size_t mid = (low + high) / 2;
+    if (End(mid) < x)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return low < segments && Contains(low, x) ? low : segments;
+}
+
+template <typename Coef>
+bool PiecewiseCubic<Coef>::Contains(std::size_t segment, double x) const {
+  return segments_[segment].x0 <= x && x <= End(segment);
+}
+
+template <typename Coef>
+double PiecewiseCubic<Coef>::End(std::size_t segment) const {
+  return segment + 1 < segments_.size() ? segments_[segment + 1].x0 : last_;
+}
+
+template <typename Coef>
+double PiecewiseCubic<Coef>::Evaluate(std::size_t segment, double x) const {
+  Segment const &s = segments_[segment];
+  double sub = x - s.x0;
+  return ((double(s.a) * sub + double(s.b)) * sub + double(s.c)) * sub +
+         double(s.d);
+}
+
+template class PiecewiseCubic<double>;
+template class PiecewiseCubic<float>;
+
+}  // namespace Interpolation
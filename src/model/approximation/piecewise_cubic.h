@@ -0,0 +1,51 @@
+#ifndef SRC_MODEL_APPROXIMATION_PIECEWISE_CUBIC_H_
+#define SRC_MODEL_APPROXIMATION_PIECEWISE_CUBIC_H_
+
+#include <vector>
+
+#include "base_approximation.h"
+#include "span.h"
+
+namespace Interpolation {
+
+// Cubic pieces between consecutive knots. Each segment is one record holding
+// its left knot and coefficients, so an evaluation touches a single cache
+// line. Records are owned and never refer back to the caller's data, a
+// built interpolant can be kept and evaluated from any number of threads.
+// Coef = float halves the coefficient storage at single precision.
+template <typename Coef>
+class PiecewiseCubic : public BaseApproximation {
+ public:
+  // Si = Ai(x-X0i)^3 + Bi(x-X0i)^2 + Ci(x-X0i) + Di
+  struct Segment {
+    double x0;
+    Coef a, b, c, d;
+  };
+
+  virtual double GetValue(double x) const override;
+  // Ascending x walk the segments forward instead of searching each time
+  virtual void GetValues(Span<const double> x, double *out) const override;
+
+  Span<const Segment> Segments() const noexcept { return segments_; }
+
+ protected:
+  PiecewiseCubic() = default;
+  ~PiecewiseCubic() = default;
+
+  // Takes one segment per interval of x, outside x the value is 0
+  void Adopt(std::vector<Segment> &&segments, Span<const double> x);
+
+ private:
+  std::vector<Segment> segments_;
+  double last_ = 0;  // right end of the last segment
+  bool sorted_ = true;
+
+  std::size_t FindSegment(double x) const;
+  bool Contains(std::size_t segment, double x) const;
+  double End(std::size_t segment) const;
+  double Evaluate(std::size_t segment, double x) const;
+};
+
+}  // namespace Interpolation
+
+#endif  // SRC_MODEL_APPROXIMATION_PIECEWISE_CUBIC_H_
@@ -0,0 +1,106 @@
+#include "power_sums.h"
+
+#include <algorithm>
+#include <array>
+
+#include "gauss.h"
+#include "polynomial.h"
+
+namespace Approximation {
+
+namespace {
+
+// Accumulates rows for a compile-time degree. The sums are kept in local
+// arrays for the whole chunk but every row is added in the same order and
+// with the same operations as PowerSums::Add, so the totals are identical.
+template <size_t Degree>
+void AddRows(double* sum_x, double* sum_y, Span<const double> x,
+             Span<const double> y, Span<const double> w) {
+  std::array<double, 2 * Degree + 1> sx;
+  std::array<double, Degree + 1> sy;
+  std::copy_n(sum_x, sx.size(), sx.begin());
+  std::copy_n(sum_y, sy.size(), sy.begin());
+
+  for (size_t i = 0; i < x.size(); ++i) {
+    double power = w[i];
+    for (size_t k = 0; k <= Degree; ++k, power *= x[i]) {
+      sx[k] += power;
+      sy[k] += power * y[i];
+    }
+    for (size_t k = Degree + 1; k < sx.size(); ++k, power *= x[i])
+      sx[k] += power;
+  }
+
+  std::copy(sx.begin(), sx.end(), sum_x);
+  std::copy(sy.begin(), sy.end(), sum_y);
+}
+
+template <size_t Size>
+std::vector<double> SolveFixed(std::vector<double> const& sum_x,
+                               std::vector<double> const& sum_y) {
+  std::array<std::array<double, Size + 1>, Size> matrix;
+  for (size_t i = 0; i < Size; ++i) {
+    for (size_t j = 0; j < Size; ++j) matrix[i][j] = sum_x[i + j];
+    matrix[i][Size] = sum_y[i];
+  }
+
+  std::array<double, Size> coefs;
+  if (!Gauss::Solve<Size>(matrix, coefs)) return {};
+  return {coefs.begin(), coefs.end()};
+}
+
+}  // namespace
+
+PowerSums::PowerSums(size_t degree)
+    : sum_x_(2 * degree + 1), sum_y_(degree + 1) {}
+
+void PowerSums::Add(double x, double y, double w) {
+  // One running product per row instead of a pow() call per power
+  double power = w;
+  size_t k = 0;
+  for (; k < sum_y_.size(); ++k, power *= x) {
+    sum_x_[k] += power;
+    sum_y_[k] += power * y;
+  }
+  for (; k < sum_x_.size(); ++k, power *= x) sum_x_[k] += power;
+  ++count_;
+}
+
+void PowerSums::Add(Span<const double> x,  //
+                    Span<const double> y,  //
+                    Span<const double> w) {
+  // Degrees 1 to 8 run with fixed size accumulators, others row by row
+  bool fixed = Polynomial::Dispatch<Polynomial::kMaxUnrolled - 1>(
+      Degree(), [&](auto degree) {
+        AddRows<decltype(degree)::value>(sum_x_.data(), sum_y_.data(), x, y,
+                                         w);
+      });
+
+  if (fixed) {
+    count_ += x.size();
+    return;
+  }
+
+  for (size_t i = 0; i < x.size(); ++i) Add(x[i], y[i], w[i]);
+}
+
+std::vector<double> PowerSums::Solve() const {
+  std::vector<double> coefs;
+  if (Polynomial::Dispatch<Polynomial::kMaxUnrolled>(
+          sum_y_.size(), [&](auto size) {
+            coefs = SolveFixed<decltype(size)::value>(sum_x_, sum_y_);
+          }))
+    return coefs;
+
+  int size = static_cast<int>(sum_y_.size());
+
+  Matrix matrix(size, size + 1);
+  for (int i = 0; i < size; ++i) {
+    for (int j = 0; j < size; ++j) matrix(i, j) = sum_x_[i + j];
+    matrix(i, size) = sum_y_[i];
+  }
+
+  return Gauss::Solve(matrix);
+}
+
+}  // namespace Approximation
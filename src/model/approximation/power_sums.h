@@ -0,0 +1,35 @@
+#ifndef SRC_MODEL_APPROXIMATION_POWER_SUMS_H_
+#define SRC_MODEL_APPROXIMATION_POWER_SUMS_H_
+
+#include <vector>
+
+#include "span.h"
+
+namespace Approximation {
+
+// Weighted sums of x^k for k <= 2 * degree and of y * x^k for k <= degree,
+// the whole state the normal equations of a polynomial fit need. Rows can
+// be added in any number of chunks, the sums only depend on their order.
+class PowerSums {
+ public:
+  explicit PowerSums(size_t degree);
+
+  void Add(double x, double y, double w);
+  void Add(Span<const double> x,  //
+           Span<const double> y,  //
+           Span<const double> w);
+
+  size_t Degree() const noexcept { return sum_y_.size() - 1; }
+  size_t Count() const noexcept { return count_; }
+
+  // Coefficients from the lowest power up, empty if the system is singular
+  [[nodiscard]] std::vector<double> Solve() const;
+
+ private:
+  std::vector<double> sum_x_, sum_y_;
+  size_t count_ = 0;
+};
+
+}  // namespace Approximation
+
+#endif  // SRC_MODEL_APPROXIMATION_POWER_SUMS_H_
@@ -0,0 +1,108 @@
+#include "smoothing_spline.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "pentadiagonal.h"
+
+namespace Approximation {
+
+namespace {
+
+// Floor for non-positive weights after scaling, such a point barely pulls
+constexpr double kMinWeight = 1e-9;
+
+}  // namespace
+
+SmoothingSpline::SmoothingSpline(Span<const double> x,  //
+                                 Span<const double> y,  //
+                                 Span<const double> w,  //
+                                 double lambda) {
+  if (x.size() != y.size() || x.size() != w.size() || x.size() < 2 ||
+      !(lambda >= 0))
+    return;
+
+  double mean = 0;
+  for (double weight : w) mean += std::max(weight, 0.0);
+  mean /= w.size();
+  if (mean == 0) mean = 1;
+
+  // Knots with the merged values and the inverse weights 1 / w_i
+  std::vector<double> knots, values, inverse;
+  knots.reserve(x.size());
+  values.reserve(x.size());
+  inverse.reserve(x.size());
+  for (std::size_t i = 0; i < x.size(); i++) {
+    double weight = std::max(w[i] / mean, kMinWeight);
+    if (!knots.empty() && x[i] == knots.back()) {
+      double total = 1 / inverse.back() + weight;
+      values.back() += (y[i] - values.back()) * weight / total;
+      inverse.back() = 1 / total;
+      continue;
+    }
+    if (!knots.empty() && x[i] < knots.back()) return;
+
+    knots.push_back(x[i]);
+    values.push_back(y[i]);
+    inverse.push_back(1 / weight);
+  }
+
+  std::size_t n = knots.size();
+  if (n < 2) return;
+
+  std::vector<double> h(n - 1), r(n - 1);
+  for (std::size_t i = 0; i + 1 < n; i++) {
+    h[i] = knots[i + 1] - knots[i];
+    r[i] = 1 / h[i];
+  }
+
+  // gamma, the second derivatives at interior knots, solves
+  // (R + lambda * Q^T * W^-1 * Q) * gamma = Q^T * y with Q tridiagonal
+  // n x (n - 2) and R tridiagonal (n - 2) x (n - 2)
+  std::size_t m = n - 2;
+  std::vector<double> diag(m), upper1(m), upper2(m), gamma(m);
+  for (std::size_t j = 0; j < m; j++) {
+    // Column j of Q has 1 / h_j, -(1 / h_j + 1 / h_j+1), 1 / h_j+1 at
+    // rows j, j + 1, j + 2
+    double q0 = r[j], q1 = -r[j] - r[j + 1], q2 = r[j + 1];
+
+    diag[j] = (h[j] + h[j + 1]) / 3 +
+              lambda * (q0 * q0 * inverse[j] + q1 * q1 * inverse[j + 1] +
+                        q2 * q2 * inverse[j + 2]);
+    if (j + 1 < m)
+      upper1[j] = h[j + 1] / 6 + lambda * (q1 * r[j + 1] * inverse[j + 1] +
+                                           q2 * (-r[j + 1] - r[j + 2]) *
+                                               inverse[j + 2]);
+    if (j + 2 < m) upper2[j] = lambda * q2 * r[j + 2] * inverse[j + 2];
+
+    gamma[j] = (values[j + 2] - values[j + 1]) * r[j + 1] -
+               (values[j + 1] - values[j]) * r[j];
+  }
+  if (!Pentadiagonal::Solve(diag, upper1, upper2, gamma)) return;
+
+  // g = y - lambda * W^-1 * Q * gamma
+  std::vector<double> g(values);
+  for (std::size_t j = 0; j < m; j++) {
+    g[j] -= lambda * inverse[j] * r[j] * gamma[j];
+    g[j + 1] -= lambda * inverse[j + 1] * (-r[j] - r[j + 1]) * gamma[j];
+    g[j + 2] -= lambda * inverse[j + 2] * r[j + 1] * gamma[j];
+  }
+
+  // Natural ends, the second derivative vanishes at the outer knots
+  auto second = [&](std::size_t i) {
+    return i == 0 || i == n - 1 ? 0 : gamma[i - 1];
+  };
+
+  std::vector<Segment> segments(n - 1);
+  for (std::size_t i = 0; i + 1 < n; i++) {
+    double left = second(i), right = second(i + 1);
+    segments[i] = {knots[i], (right - left) / (6 * h[i]), left / 2,
+                   (g[i + 1] - g[i]) * r[i] - h[i] * (2 * left + right) / 6,
+                   g[i]};
+  }
+
+  Adopt(std::move(segments), knots);
+}
+
+}  // namespace Approximation
@@ -0,0 +1,33 @@
+#ifndef SRC_MODEL_APPROXIMATION_SMOOTHING_SPLINE_H_
+#define SRC_MODEL_APPROXIMATION_SMOOTHING_SPLINE_H_
+
+#include "piecewise_cubic.h"
+#include "span.h"
+
+namespace Approximation {
+
+// Reinsch smoothing spline, the natural cubic g minimizing
+//
+//   sum(w_i * (y_i - g(x_i))^2) + lambda * integral(g''(x)^2)
+//
+// lambda = 0 interpolates, a growing lambda tends to the weighted least
+// squares line. Weights are scaled to a mean of 1, so lambda does not
+// depend on their units. Points sharing a key are merged into their
+// weighted mean. The system for the second derivatives is pentadiagonal and
+// solved in O(n).
+class SmoothingSpline : public Interpolation::PiecewiseCubic<double> {
+ public:
+  SmoothingSpline(Span<const double> x,  //
+                  Span<const double> y,  //
+                  Span<const double> w,  //
+                  double lambda);
+  ~SmoothingSpline() = default;
+  SmoothingSpline(SmoothingSpline&&) = delete;
+  SmoothingSpline(const SmoothingSpline&) = delete;
+  SmoothingSpline& operator=(SmoothingSpline&&) = delete;
+  SmoothingSpline& operator=(const SmoothingSpline&) = delete;
+};
+
+}  // namespace Approximation
+
+#endif  // SRC_MODEL_APPROXIMATION_SMOOTHING_SPLINE_H_
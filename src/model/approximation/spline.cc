@@ -1,21 +1,34 @@
 #include "spline.h"
 
 #include <cmath>
+#include <utility>
 
 #include "gauss.h"
 
 namespace Interpolation {
 
-Spline::Spline(std::vector<double> const &x, std::vector<double> const &y)
-    : x_(x), y_(y) {
+template <typename Coef>
+BasicSpline<Coef>::BasicSpline(Span<const double> x, Span<const double> y) {
   if (x.size() != y.size() || x.size() < 2) return;
 
-  coefs_ = CalcCoef();
+  Matrix coefs = CalcCoef(x, y);
+  if (!coefs.Rows()) return;
+
+  std::vector<typename BasicSpline::Segment> segments;
+  segments.reserve(coefs.Rows());
+  for (int i = 0; i < coefs.Rows(); i++)
+    segments.push_back({x[i], static_cast<Coef>(coefs(i, 0)),
+                        static_cast<Coef>(coefs(i, 1)),
+                        static_cast<Coef>(coefs(i, 2)),
+                        static_cast<Coef>(coefs(i, 3))});
+  this->Adopt(std::move(segments), x);
 }
 
-Matrix Spline::CalcCoef() {
+template <typename Coef>
+Matrix BasicSpline<Coef>::CalcCoef(Span<const double> x,
+                                   Span<const double> y) const {
   const int k_coef_num = 4;
-  int splines = x_.size() - 1;
+  int splines = x.size() - 1;
   Matrix matrix(splines * k_coef_num, splines * k_coef_num + 1);
 
   // Si = Ai(x-X0i)^3 + Bi(x-X0i)^2 + Ci(x-X0i) + Di
@@ -25,22 +38,22 @@ Matrix Spline::CalcCoef() {
   // Fill Gauss Matrix
   for (int i = 0; i < splines; i++, row++) {
     matrix(row, matrix.Cols() - (splines - i) - 1) = 1;
-    matrix(row, matrix.Cols() - 1) = y_.at(i);
+    matrix(row, matrix.Cols() - 1) = y[i];
   }
 
   for (int i = 0; i < splines; i++, row++) {
-    double sub = x_.at(i + 1) - x_.at(i);
+    double sub = x[i + 1] - x[i];
 
     matrix(row, i) = pow(sub, 3);
     matrix(row, i + splines) = pow(sub, 2);
     matrix(row, i + splines * 2) = sub;
     matrix(row, i + splines * 3) = 1;
 
-    matrix(row, matrix.Cols() - 1) = y_.at(i + 1);
+    matrix(row, matrix.Cols() - 1) = y[i + 1];
   }
 
   for (int i = 0; i < splines; i++, row++) {
-    double sub = x_.at(i + 1) - x_.at(i);
+    double sub = x[i + 1] - x[i];
 
     matrix(row, i) = 6 * sub;
     matrix(row, i + splines) = 2;
@@ -49,7 +62,7 @@ Matrix Spline::CalcCoef() {
   }
 
   for (int i = 0; i < splines - 1; i++, row++) {
-    double sub = x_.at(i + 1) - x_.at(i);
+    double sub = x[i + 1] - x[i];
 
     matrix(row, i) = 3 * pow(sub, 2);
     matrix(row, i + splines) = 2 * sub;
@@ -70,19 +83,7 @@ Matrix Spline::CalcCoef() {
   return coefs;
 }
 
-double Spline::GetValue(double x) const {
-  // Si = Ai(x-X0i)^3 + Bi(x-X0i)^2 + Ci(x-X0i) + Di
-
-  for (int i = 0; i < coefs_.Rows(); i++)
-    if (x_[i] <= x && x <= x_[i + 1]) {
-      double sub = x - x_[i];
-      return coefs_(i, 0) * pow(sub, 3) +  //
-             coefs_(i, 1) * pow(sub, 2) +  //
-             coefs_(i, 2) * sub +          //
-             coefs_(i, 3);
-    }
-
-  return 0;
-}
+template class BasicSpline<double>;
+template class BasicSpline<float>;
 
 }  // namespace Interpolation
@@ -1,31 +1,30 @@
 #ifndef SRC_MODEL_APPROXIMATION_SPLINE_H_
 #define SRC_MODEL_APPROXIMATION_SPLINE_H_
 
-#include <vector>
-
-#include "base_approximation.h"
 #include "matrix.h"
+#include "piecewise_cubic.h"
+#include "span.h"
 
 namespace Interpolation {
 
-class Spline : public BaseApproximation {
+// Natural cubic spline
+template <typename Coef>
+class BasicSpline : public PiecewiseCubic<Coef> {
  public:
-  Spline(std::vector<double> const &x, std::vector<double> const &y);
-  ~Spline() = default;
-  Spline(Spline &&) = delete;
-  Spline(const Spline &) = delete;
-  Spline &operator=(Spline &&) = delete;
-  Spline &operator=(const Spline &) = delete;
-
-  virtual double GetValue(double x) const override;
+  BasicSpline(Span<const double> x, Span<const double> y);
+  ~BasicSpline() = default;
+  BasicSpline(BasicSpline &&) = delete;
+  BasicSpline(const BasicSpline &) = delete;
+  BasicSpline &operator=(BasicSpline &&) = delete;
+  BasicSpline &operator=(const BasicSpline &) = delete;
 
  private:
-  Matrix coefs_;
-  const std::vector<double> &x_, &y_;
-
-  Matrix CalcCoef();
+  Matrix CalcCoef(Span<const double> x, Span<const double> y) const;
 };
 
+using Spline = BasicSpline<double>;
+using FloatSpline = BasicSpline<float>;
+
 }  // namespace Interpolation
 
 #endif  // SRC_MODEL_APPROXIMATION_SPLINE_H_
@@ -0,0 +1,30 @@
+#include "streaming_least_squares.h"
+
+#include "polynomial.h"
+
+namespace Approximation {
+
+StreamingLeastSquares::StreamingLeastSquares(size_t degree) : sums_(degree) {}
+
+void StreamingLeastSquares::Add(Span<const double> x,  //
+                                Span<const double> y,  //
+                                Span<const double> w) {
+  if (x.size() != y.size() || x.size() != w.size()) return;
+  sums_.Add(x, y, w);
+}
+
+void StreamingLeastSquares::Fit() {
+  if (sums_.Count() == 0 || sums_.Degree() == 0) return;
+  coefs_ = sums_.Solve();
+}
+
+double StreamingLeastSquares::GetValue(double x) const {
+  return Polynomial::Horner(coefs_, x);
+}
+
+void StreamingLeastSquares::GetValues(Span<const double> x,
+                                      double* out) const {
+  Polynomial::Evaluate(coefs_, x, out);
+}
+
+}  // namespace Approximation
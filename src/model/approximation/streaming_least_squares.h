@@ -0,0 +1,44 @@
+#ifndef SRC_MODEL_APPROXIMATION_STREAMING_LEAST_SQUARES_H_
+#define SRC_MODEL_APPROXIMATION_STREAMING_LEAST_SQUARES_H_
+
+#include <vector>
+
+#include "base_approximation.h"
+#include "power_sums.h"
+#include "span.h"
+
+namespace Approximation {
+
+// Least squares fit over data that never has to be in memory at once. Rows
+// are fed chunk by chunk into the power sums, so memory stays O(degree), and
+// fitting the same rows in the same order gives exactly the coefficients of
+// LeastSquares, which solves the same sums.
+class StreamingLeastSquares : public BaseApproximation {
+ public:
+  explicit StreamingLeastSquares(size_t degree);
+  ~StreamingLeastSquares() = default;
+  StreamingLeastSquares(StreamingLeastSquares&&) = delete;
+  StreamingLeastSquares(const StreamingLeastSquares&) = delete;
+  StreamingLeastSquares& operator=(StreamingLeastSquares&&) = delete;
+  StreamingLeastSquares& operator=(const StreamingLeastSquares&) = delete;
+
+  void Add(Span<const double> x,  //
+           Span<const double> y,  //
+           Span<const double> w);
+
+  // Solves for the coefficients of everything added so far
+  void Fit();
+
+  double GetValue(double x) const override;
+  void GetValues(Span<const double> x, double* out) const override;
+  std::vector<double> const& Coefs() const noexcept { return coefs_; }
+  size_t Count() const noexcept { return sums_.Count(); }
+
+ private:
+  PowerSums sums_;
+  std::vector<double> coefs_;
+};
+
+}  // namespace Approximation
+
+#endif  // SRC_MODEL_APPROXIMATION_STREAMING_LEAST_SQUARES_H_
@@ -0,0 +1,236 @@
+#include "backtest.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "gauss.h"
+#include "thread_pool.h"
+
+namespace Backtest {
+
+// Least squares polynomial over the recent bars. Keys are shifted to the
+// first bar of the fit and scaled by its span, so the normal equations stay
+// well conditioned however far into the series the fit is.
+//
+// A window is summed afresh on every refit, O(window) per refit, since
+// removing old bars from running power sums cancels catastrophically. An
+// expanding fit adds each bar to its sums once, O(1) per bar. Its key
+// offsets are never negative, so those sums only grow by positive terms and
+// scaling them at solve time loses no precision.
+class Engine::Forecast {
+ public:
+  Forecast(SeriesView const& series, size_t window)
+      : series_(series), window_(window) {}
+
+  // Adds bar to the expanding sums, a no-op for windowed fits
+  template <size_t Degree>
+  void Add(size_t bar);
+  // Fits the bars up to and including bar, false if too few or singular
+  template <size_t Degree>
+  bool Fit(size_t bar);
+  // Value horizon bars after bar, at the mean key step of the last fit
+  template <size_t Degree>
+  double At(size_t bar, size_t horizon) const;
+
+ private:
+  SeriesView series_;
+  size_t window_;
+  double sum_x_[2 * kMaxDegree + 1] = {}, sum_y_[kMaxDegree + 1] = {};
+  double coefs_[kMaxDegree + 1] = {};
+  double origin_ = 0, scale_ = 1, step_ = 0;
+
+  template <size_t Degree>
+  static void Accumulate(double x, double y, double w, double* sum_x,
+                         double* sum_y);
+  template <size_t Degree>
+  bool Solve(double const* sum_x, double const* sum_y);
+};
+
+template <size_t Degree>
+void Engine::Forecast::Accumulate(double x, double y, double w, double* sum_x,
+                                  double* sum_y) {
+  double power = w;
+  for (size_t k = 0; k <= Degree; ++k, power *= x) {
+    sum_x[k] += power;
+    sum_y[k] += power * y;
+  }
+  for (size_t k = Degree + 1; k <= 2 * Degree; ++k, power *= x)
+    sum_x[k] += power;
+}
+
+template <size_t Degree>
+void Engine::Forecast::Add(size_t bar) {
+  if (window_) return;
+  if (bar == 0) origin_ = series_.keys[0];
+  Accumulate<Degree>(series_.keys[bar] - origin_, series_.values[bar],
+                     series_.weights[bar], sum_x_, sum_y_);
+}
+
+template <size_t Degree>
+bool Engine::Forecast::Fit(size_t bar) {
+  size_t first = window_ ? bar + 1 - std::min(window_, bar + 1) : 0;
+  if (bar - first < Degree + 1 || (window_ && bar - first + 1 < window_))
+    return false;
+
+  double span = series_.keys[bar] - series_.keys[first];
+  if (!(span > 0)) return false;
+
+  if (!window_) {
+    // Rescales the running sums to keys in [0, 1]
+    double sum_x[2 * Degree + 1], sum_y[Degree + 1], power = 1;
+    for (size_t k = 0; k <= 2 * Degree; ++k, power /= span) {
+      sum_x[k] = sum_x_[k] * power;
+      if (k <= Degree) sum_y[k] = sum_y_[k] * power;
+    }
+    if (!Solve<Degree>(sum_x, sum_y)) return false;
+  } else {
+    double sum_x[2 * Degree + 1] = {}, sum_y[Degree + 1] = {};
+    double origin = series_.keys[first], inverse = 1 / span;
+    for (size_t i = first; i <= bar; ++i)
+      Accumulate<Degree>((series_.keys[i] - origin) * inverse,
+                         series_.values[i], series_.weights[i], sum_x, sum_y);
+    if (!Solve<Degree>(sum_x, sum_y)) return false;
+    origin_ = origin;
+  }
+
+  scale_ = span;
+  step_ = span / (bar - first);
+  return true;
+}
+
+template <size_t Degree>
+bool Engine::Forecast::Solve(double const* sum_x, double const* sum_y) {
+  constexpr size_t kSize = Degree + 1;
+  std::array<std::array<double, kSize + 1>, kSize> matrix;
+  for (size_t i = 0; i < kSize; ++i) {
+    for (size_t j = 0; j < kSize; ++j) matrix[i][j] = sum_x[i + j];
+    matrix[i][kSize] = sum_y[i];
+  }
+
+  std::array<double, kSize> coefs;
+  if (!Gauss::Solve<kSize>(matrix, coefs)) return false;
+  std::copy(coefs.begin(), coefs.end(), coefs_);
+  return true;
+}
+
+template <size_t Degree>
+double Engine::Forecast::At(size_t bar, size_t horizon) const {
+  double key = series_.keys[bar] + horizon * step_;
+  return Polynomial::FixedHorner<Degree + 1>(coefs_, (key - origin_) / scale_);
+}
+
+Stats Engine::Run(Params const& params, Workspace& workspace) const {
+  if (params.degree > kMaxDegree)
+    throw std::invalid_argument("Backtest degree above " +
+                                std::to_string(kMaxDegree));
+  if (params.window && params.window < params.degree + 2)
+    throw std::invalid_argument("Backtest window too short for the degree");
+  if (!params.refit || !params.latency)
+    throw std::invalid_argument("Backtest refit and latency must be positive");
+
+  Stats stats;
+  Polynomial::Dispatch<kMaxDegree + 1>(params.degree + 1, [&](auto size) {
+    stats = Run<decltype(size)::value - 1>(params, workspace);
+  });
+  return stats;
+}
+
+template <size_t Degree>
+Stats Engine::Run(Params const& params, Workspace& workspace) const {
+  size_t size = series_.Size();
+  const double* close = series_.values.data();
+
+  // Sized once per workspace, later runs over the same series reuse them
+  auto& equity = workspace.equity;
+  auto& fills = workspace.fills;
+  auto& orders = workspace.orders;
+  equity.resize(size);
+  fills.clear();
+  fills.reserve(size);
+  orders.assign(params.latency, 0);
+
+  Forecast forecast(series_, params.window);
+  Stats stats;
+  double position = 0, expected = 0, pnl = 0, peak = 0, mean = 0, m2 = 0;
+  bool fitted = false;
+  size_t since_fit = params.refit;
+
+  for (size_t i = 0; i < size; ++i) {
+    double change = i ? position * (close[i] - close[i - 1]) : 0;
+
+    // The slot of this bar holds what was queued latency bars ago
+    double& due = orders[i % params.latency];
+    if (due != 0) {
+      double cost = params.cost * std::fabs(due) * close[i];
+      fills.push_back({i, due, close[i], cost});
+      change -= cost;
+      position += due;
+      due = 0;
+    }
+
+    pnl += change;
+    equity[i] = pnl;
+    peak = std::max(peak, pnl);
+    stats.max_drawdown = std::max(stats.max_drawdown, peak - pnl);
+    if (position != 0) ++stats.bars_in_market;
+    if (i) {
+      double delta = change - mean;
+      mean += delta / i;
+      m2 += delta * (change - mean);
+    }
+
+    forecast.Add<Degree>(i);
+    if (++since_fit >= params.refit && forecast.Fit<Degree>(i)) {
+      fitted = true;
+      since_fit = 0;
+    }
+    if (!fitted) continue;
+
+    double move = forecast.At<Degree>(i, params.horizon) / close[i] - 1;
+    double target = move > params.threshold ? 1
+                    : move < -params.threshold && params.allow_short ? -1
+                                                                     : 0;
+    if (target != expected) {
+      due = target - expected;
+      expected = target;
+    }
+  }
+
+  stats.pnl = pnl;
+  stats.trades = fills.size();
+  if (size > 2 && m2 > 0) stats.sharpe = mean / std::sqrt(m2 / (size - 2));
+  return stats;
+}
+
+std::vector<Stats> Engine::Sweep(std::vector<Params> const& params) const {
+  std::vector<Stats> stats(params.size());
+  std::vector<std::exception_ptr> errors(params.size());
+  std::atomic<size_t> next = 0;
+
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  ThreadPool pool;
+  for (size_t t = 0; t < std::min(threads, params.size()); ++t)
+    pool.AddTask([&] {
+      Workspace workspace;
+      for (size_t i; (i = next++) < params.size();) {
+        try {
+          stats[i] = Run(params[i], workspace);
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      }
+    });
+  pool.WaitAll();
+
+  for (auto& error : errors)
+    if (error) std::rethrow_exception(error);
+  return stats;
+}
+
+}  // namespace Backtest
@@ -0,0 +1,86 @@
+#ifndef SRC_MODEL_BACKTEST_H_
+#define SRC_MODEL_BACKTEST_H_
+
+#include <vector>
+
+#include "polynomial.h"
+#include "price_series.h"
+
+// Trades a fitted polynomial forecast over a series, bar by bar and without
+// looking ahead. Every bar is processed as a fixed sequence of events:
+//
+//   fill     orders that came due execute at the close, paying costs
+//   mark     the position held since the previous bar is marked to market
+//   fit      the forecast is refitted when due
+//   signal   the forecast sets a target position, the difference to the
+//            position including orders in flight is queued as an order
+//            that fills latency bars later
+//
+// All per-run state lives in a Workspace. Once it is sized, repeated runs
+// allocate nothing, so parameter sweeps cost only the bar loop.
+namespace Backtest {
+
+// Fits run on fixed size arrays, one instantiation per degree
+constexpr size_t kMaxDegree = Polynomial::kMaxUnrolled - 1;
+
+struct Params {
+  size_t degree = 1;
+  size_t window = 50;    // bars per fit, 0 for every bar so far
+  size_t refit = 1;      // bars between refits
+  size_t horizon = 5;    // bars ahead of the forecast
+  size_t latency = 1;    // bars from a signal to its fill
+  double threshold = 0;  // relative move the forecast must exceed to trade
+  double cost = 0;       // fraction of the traded notional paid per fill
+  bool allow_short = true;
+};
+
+struct Fill {
+  size_t bar;
+  double quantity, price, cost;
+};
+
+// P&L is in price units for a position of one unit. Sharpe is the mean over
+// the standard deviation of per-bar P&L, not annualized.
+struct Stats {
+  double pnl = 0, max_drawdown = 0, sharpe = 0;
+  size_t trades = 0, bars_in_market = 0;
+};
+
+struct Workspace {
+  std::vector<double> equity;  // cumulative P&L after every bar
+  std::vector<Fill> fills;
+  std::vector<double> orders;  // quantities in flight, one slot per bar
+};
+
+// Keeps a view of the series, which must outlive the engine. Run and Sweep
+// are const, one engine serves any number of threads.
+class Engine {
+ public:
+  explicit Engine(SeriesView const& series) : series_(series) {}
+  ~Engine() = default;
+  Engine(Engine&&) = delete;
+  Engine(const Engine&) = delete;
+  Engine& operator=(Engine&&) = delete;
+  Engine& operator=(const Engine&) = delete;
+
+  // Throws std::invalid_argument for a degree above kMaxDegree, a window
+  // shorter than degree + 2 bars, or a zero refit interval or latency
+  Stats Run(Params const& params, Workspace& workspace) const;
+
+  // Runs every parameter set on the thread pool. Threads take the next
+  // pending set as they finish and keep one workspace each.
+  [[nodiscard]] std::vector<Stats> Sweep(
+      std::vector<Params> const& params) const;
+
+ private:
+  class Forecast;
+
+  SeriesView series_;
+
+  template <size_t Degree>
+  Stats Run(Params const& params, Workspace& workspace) const;
+};
+
+}  // namespace Backtest
+
+#endif  // SRC_MODEL_BACKTEST_H_
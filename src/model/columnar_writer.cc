@@ -0,0 +1,121 @@
+#include "columnar_writer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[8] = {'A', 'T', 'C', 'O', 'L', '\0', '\0', '\1'};
+constexpr size_t kAlignment = 64;
+
+size_t AlignUp(size_t offset) {
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// Appends fixed width integers and strings, assumes a little endian host
+class Encoder {
+ public:
+  explicit Encoder(char* out) : out_(out) {}
+
+  template <typename T>
+  void Put(T value) { PutBytes(&value, sizeof(value)); }
+
+  void Put(std::string const& str) {
+    Put(static_cast<uint32_t>(str.size()));
+    PutBytes(str.data(), str.size());
+  }
+
+  void PutBytes(const void* data, size_t size) {
+    std::memcpy(out_ + size_, data, size);
+    size_ += size;
+  }
+
+ private:
+  char* out_;
+  size_t size_ = 0;
+};
+
+}  // namespace
+
+ColumnarWriter::Column ColumnarWriter::Float64(std::string name,
+                                               Span<const double> data) {
+  return Float64(std::move(name), data.data(), data.size(), sizeof(double));
+}
+
+ColumnarWriter::Column ColumnarWriter::Float64(std::string name,
+                                               const double* data,
+                                               size_t rows, size_t stride) {
+  return {std::move(name), Type::kFloat64, data, rows, stride};
+}
+
+ColumnarWriter::Column ColumnarWriter::Int64(std::string name,
+                                             Span<const int64_t> data) {
+  return {std::move(name), Type::kInt64, data.data(), data.size(),
+          sizeof(int64_t)};
+}
+
+void ColumnarWriter::AddTable(std::string name, std::vector<Column> columns) {
+  size_t rows = columns.empty() ? 0 : columns.front().rows;
+  for (auto const& column : columns)
+    if (column.rows != rows)
+      throw std::invalid_argument("Columns of a table differ in length");
+
+  tables_.push_back({std::move(name), rows, std::move(columns)});
+}
+
+void ColumnarWriter::Write(std::string const& filename) const {
+  // Sizes the metadata first so data offsets are known before encoding
+  size_t meta = sizeof(kMagic) + sizeof(uint32_t);
+  for (auto const& table : tables_) {
+    meta += sizeof(uint32_t) + table.name.size() + sizeof(uint64_t) +
+            sizeof(uint32_t);
+    for (auto const& column : table.columns)
+      meta += sizeof(uint32_t) + column.name.size() + sizeof(uint8_t) +
+              sizeof(uint64_t);
+  }
+
+  size_t total = AlignUp(meta);
+  for (auto const& table : tables_)
+    for (size_t i = 0; i < table.columns.size(); ++i)
+      total = AlignUp(total + table.rows * sizeof(double));
+
+  std::unique_ptr<char[]> buffer(new char[total]());
+  Encoder encoder(buffer.get());
+  encoder.PutBytes(kMagic, sizeof(kMagic));
+  encoder.Put(static_cast<uint32_t>(tables_.size()));
+
+  size_t offset = AlignUp(meta);
+  for (auto const& table : tables_) {
+    encoder.Put(table.name);
+    encoder.Put(static_cast<uint64_t>(table.rows));
+    encoder.Put(static_cast<uint32_t>(table.columns.size()));
+
+    for (auto const& column : table.columns) {
+      encoder.Put(column.name);
+      encoder.Put(static_cast<uint8_t>(column.type));
+      encoder.Put(static_cast<uint64_t>(offset));
+
+      // Both types are 8 bytes wide, a dense column is a single memcpy
+      auto src = static_cast<const char*>(column.data);
+      char* dst = buffer.get() + offset;
+      if (column.stride == sizeof(double)) {
+        if (column.rows) std::memcpy(dst, src, column.rows * sizeof(double));
+      } else {
+        for (size_t row = 0; row < column.rows; ++row)
+          std::memcpy(dst + row * sizeof(double), src + row * column.stride,
+                      sizeof(double));
+      }
+      offset = AlignUp(offset + column.rows * sizeof(double));
+    }
+  }
+
+  FILE* file = std::fopen(filename.c_str(), "wb");
+  if (!file) throw std::runtime_error("Could not create " + filename);
+  std::setvbuf(file, nullptr, _IONBF, 0);
+
+  bool written = std::fwrite(buffer.get(), 1, total, file) == total;
+  written = std::fclose(file) == 0 && written;
+  if (!written) throw std::runtime_error("Could not write " + filename);
+}
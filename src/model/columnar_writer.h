@@ -0,0 +1,56 @@
+#ifndef SRC_MODEL_COLUMNAR_WRITER_H_
+#define SRC_MODEL_COLUMNAR_WRITER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "span.h"
+
+// Writes named tables of typed columns to a binary file that other tools can
+// map and read without parsing. The whole file is assembled in one buffer and
+// written with a single call. Layout, all integers little endian:
+//
+//   magic       8 bytes   "ATCOL\0\0\1"
+//   tables      u32
+//   per table   u32 name length, name, u64 rows, u32 columns
+//   per column  u32 name length, name, u8 type (0 float64, 1 int64),
+//               u64 byte offset of the data from the start of the file
+//   data        every column as one contiguous array, 64 byte aligned
+class ColumnarWriter {
+ public:
+  enum class Type : uint8_t { kFloat64, kInt64 };
+
+  // A column is read through a byte stride, so interleaved sources such as
+  // QCPGraphData keys and values are gathered without a staging copy
+  struct Column {
+    std::string name;
+    Type type;
+    const void* data;
+    size_t rows, stride;
+  };
+
+  static Column Float64(std::string name, Span<const double> data);
+  static Column Float64(std::string name, const double* data, size_t rows,
+                        size_t stride);
+  static Column Int64(std::string name, Span<const int64_t> data);
+
+  // Columns must outlive Write. Throws std::invalid_argument when they differ
+  // in length.
+  void AddTable(std::string name, std::vector<Column> columns);
+  void Clear() noexcept { tables_.clear(); }
+
+  // Throws std::runtime_error when the file can not be written
+  void Write(std::string const& filename) const;
+
+ private:
+  struct Table {
+    std::string name;
+    size_t rows;
+    std::vector<Column> columns;
+  };
+
+  std::vector<Table> tables_;
+};
+
+#endif  // SRC_MODEL_COLUMNAR_WRITER_H_
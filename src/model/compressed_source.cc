@@ -0,0 +1,253 @@
+#include "compressed_source.h"
+
+#include <cerrno>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+// Compressed input is pulled in chunks of this size when streaming a file
+constexpr size_t kInputChunk = 1 << 18;
+
+}  // namespace
+
+class CompressedSource::Codec {
+ public:
+  virtual ~Codec() = default;
+
+  // Inflates from [next, end) into out, advancing next. Returns the number of
+  // bytes produced, throws CompressedSource::Error on corrupt input.
+  virtual size_t Decompress(const char*& next, const char* end, char* out,
+                            size_t size) = 0;
+
+  // Whether the stream ended on a frame boundary
+  [[nodiscard]] virtual bool Finished() const = 0;
+};
+
+#ifdef HAVE_ZLIB
+class CompressedSource::GzipCodec : public Codec {
+ public:
+  GzipCodec() {
+    // 15 + 32: maximum window, gzip or zlib header detected automatically
+    if (inflateInit2(&stream_, 15 + 32) != Z_OK)
+      throw Error("Could not initialize zlib");
+  }
+
+  ~GzipCodec() override { inflateEnd(&stream_); }
+
+  size_t Decompress(const char*& next, const char* end, char* out,
+                    size_t size) override {
+    // A member ended and more data follows: concatenated gzip members
+    if (finished_ && next != end) {
+      inflateReset(&stream_);
+      finished_ = false;
+    }
+    if (finished_) return 0;
+
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(next));
+    stream_.avail_in = static_cast<uInt>(end - next);
+    stream_.next_out = reinterpret_cast<Bytef*>(out);
+    stream_.avail_out = static_cast<uInt>(size);
+
+    int status = inflate(&stream_, Z_NO_FLUSH);
+    if (status == Z_STREAM_END)
+      finished_ = true;
+    else if (status != Z_OK && status != Z_BUF_ERROR)
+      throw Error(stream_.msg ? stream_.msg : "Corrupt gzip stream");
+
+    next = reinterpret_cast<const char*>(stream_.next_in);
+    return size - stream_.avail_out;
+  }
+
+  [[nodiscard]] bool Finished() const override { return finished_; }
+
+ private:
+  z_stream stream_{};
+  bool finished_ = false;
+};
+#endif
+
+#ifdef HAVE_ZSTD
+class CompressedSource::ZstdCodec : public Codec {
+ public:
+  ZstdCodec() : stream_(ZSTD_createDStream()) {
+    if (!stream_) throw Error("Could not initialize zstd");
+  }
+
+  ~ZstdCodec() override { ZSTD_freeDStream(stream_); }
+
+  size_t Decompress(const char*& next, const char* end, char* out,
+                    size_t size) override {
+    ZSTD_inBuffer input{next, static_cast<size_t>(end - next), 0};
+    ZSTD_outBuffer output{out, size, 0};
+
+    // Decodes consecutive frames on its own, returns 0 on a frame boundary
+    size_t status = ZSTD_decompressStream(stream_, &output, &input);
+    if (ZSTD_isError(status)) throw Error(ZSTD_getErrorName(status));
+
+    finished_ = status == 0;
+    next += input.pos;
+    return output.pos;
+  }
+
+  [[nodiscard]] bool Finished() const override { return finished_; }
+
+ private:
+  ZSTD_DStream* stream_;
+  bool finished_ = true;
+};
+#endif
+
+CompressedSource::Format CompressedSource::Detect(const char* data,
+                                                  size_t size) {
+  auto bytes = reinterpret_cast<const unsigned char*>(data);
+  if (size >= 2 && bytes[0] == 0x1F && bytes[1] == 0x8B) return Format::kGzip;
+  if (size >= 4 && bytes[0] == 0x28 && bytes[1] == 0xB5 && bytes[2] == 0x2F &&
+      bytes[3] == 0xFD)
+    return Format::kZstd;
+  return Format::kNone;
+}
+
+CompressedSource::Format CompressedSource::Detect(
+    std::string const& filename) {
+  char magic[4] = {};
+  size_t size = 0;
+  if (FILE* file = std::fopen(filename.c_str(), "rb")) {
+    size = std::fread(magic, 1, sizeof(magic), file);
+    std::fclose(file);
+  }
+  return Detect(magic, size);
+}
+
+bool CompressedSource::Supported(Format format) {
+  switch (format) {
+    case Format::kNone:
+      return true;
+    case Format::kGzip:
+#ifdef HAVE_ZLIB
+      return true;
+#else
+      return false;
+#endif
+    case Format::kZstd:
+#ifdef HAVE_ZSTD
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+uintmax_t CompressedSource::EstimateBytes(uintmax_t bytes, Format format) {
+  // Typical ratios for numeric csv, only used to size buffers up front
+  switch (format) {
+    case Format::kNone:
+      return bytes;
+    case Format::kGzip:
+      return bytes * 4;
+    case Format::kZstd:
+      return bytes * 5;
+  }
+  return bytes;
+}
+
+CompressedSource::CompressedSource(std::string const& filename, Format format)
+    : filename_(filename), input_(kInputChunk) {
+  file_ = std::fopen(filename.c_str(), "rb");
+  if (!file_) {
+    io::error::can_not_open_file err;
+    err.set_errno(errno);
+    err.set_file_name(filename.c_str());
+    throw err;
+  }
+  std::setvbuf(file_, nullptr, _IONBF, 0);
+  next_ = end_ = input_.data();
+
+  try {
+    Init(format);
+  } catch (...) {
+    std::fclose(file_);
+    throw;
+  }
+}
+
+CompressedSource::CompressedSource(std::string const& filename,
+                                   const char* begin, const char* end,
+                                   Format format)
+    : filename_(filename), next_(begin), end_(end), eof_(true) {
+  Init(format);
+}
+
+CompressedSource::~CompressedSource() {
+  if (file_) std::fclose(file_);
+}
+
+void CompressedSource::Init(Format format) {
+  switch (format) {
+    case Format::kGzip:
+#ifdef HAVE_ZLIB
+      codec_ = std::make_unique<GzipCodec>();
+      return;
+#else
+      Fail("Built without gzip support");
+#endif
+    case Format::kZstd:
+#ifdef HAVE_ZSTD
+      codec_ = std::make_unique<ZstdCodec>();
+      return;
+#else
+      Fail("Built without zstd support");
+#endif
+    case Format::kNone:
+      break;
+  }
+  Fail("Not a compressed stream");
+}
+
+bool CompressedSource::Refill() {
+  if (eof_) return false;
+
+  size_t size = std::fread(input_.data(), 1, input_.size(), file_);
+  if (size < input_.size()) {
+    if (std::ferror(file_)) Fail("Read error");
+    eof_ = true;
+  }
+  next_ = input_.data();
+  end_ = next_ + size;
+  return size > 0;
+}
+
+void CompressedSource::Fail(const char* reason) const {
+  Error err(reason);
+  err.set_file_name(filename_.c_str());
+  throw err;
+}
+
+int CompressedSource::read(char* buffer, int size) {
+  size_t produced = 0, want = static_cast<size_t>(size);
+
+  try {
+    while (produced < want) {
+      if (next_ == end_) Refill();
+
+      size_t count =
+          codec_->Decompress(next_, end_, buffer + produced, want - produced);
+      produced += count;
+
+      // Input exhausted and the codec has nothing buffered
+      if (count == 0 && next_ == end_ && eof_) break;
+    }
+  } catch (Error& err) {
+    err.set_file_name(filename_.c_str());
+    throw;
+  }
+
+  if (produced < want && !codec_->Finished()) Fail("Truncated stream");
+  return static_cast<int>(produced);
+}
@@ -0,0 +1,69 @@
+#ifndef SRC_MODEL_COMPRESSED_SOURCE_H_
+#define SRC_MODEL_COMPRESSED_SOURCE_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "csv.h"
+
+// Byte source for csv.h that inflates a gzip or zstd stream, either from a
+// file or from a buffer already in memory. LineReader pulls from its byte
+// source on the asynchronous reader thread, so decompression runs there and
+// overlaps with parsing, no temporary file is ever written. Support for each
+// format is compiled in when HAVE_ZLIB / HAVE_ZSTD are defined.
+class CompressedSource : public io::ByteSourceBase {
+ public:
+  enum class Format { kNone, kGzip, kZstd };
+
+  struct Error : io::error::base, io::error::with_file_name {
+    explicit Error(const char* reason = "") : reason(reason) {}
+
+    void format_error_message() const override {
+      std::snprintf(error_message_buffer, sizeof(error_message_buffer),
+                    R"(%s in file "%s".)", reason, file_name);
+    }
+
+    const char* reason;
+  };
+
+  // Recognizes the format by its magic number
+  static Format Detect(const char* data, size_t size);
+  static Format Detect(std::string const& filename);
+  static bool Supported(Format format);
+
+  // Rough decompressed size of a csv file from its size on disk
+  static uintmax_t EstimateBytes(uintmax_t bytes, Format format);
+
+  CompressedSource(std::string const& filename, Format format);
+  CompressedSource(std::string const& filename, const char* begin,
+                   const char* end, Format format);
+  ~CompressedSource() override;
+
+  CompressedSource(CompressedSource const&) = delete;
+  CompressedSource(CompressedSource&&) = delete;
+  CompressedSource& operator=(CompressedSource const&) = delete;
+  CompressedSource& operator=(CompressedSource&&) = delete;
+
+  int read(char* buffer, int size) override;
+
+ private:
+  class Codec;
+  class GzipCodec;
+  class ZstdCodec;
+
+  void Init(Format format);
+  bool Refill();
+  [[noreturn]] void Fail(const char* reason) const;
+
+  std::string filename_;
+  std::unique_ptr<Codec> codec_;
+  FILE* file_ = nullptr;
+  std::vector<char> input_;
+  const char *next_ = nullptr, *end_ = nullptr;
+  bool eof_ = false;
+};
+
+#endif  // SRC_MODEL_COMPRESSED_SOURCE_H_
@@ -0,0 +1,247 @@
+#ifndef SRC_MODEL_CSV_SCHEMA_H_
+#define SRC_MODEL_CSV_SCHEMA_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "csv.h"
+#include "date.h"
+
+// Names the columns to materialize from a csv file and their types. Columns
+// of the file that are not listed are never converted.
+class CsvSchema {
+ public:
+  enum class Type { kDouble, kInt64, kDate, kTimestamp };
+
+  struct Field {
+    std::string name;
+    Type type = Type::kDouble;
+    bool required = true;
+    double fallback = 0;  // used when an optional field is absent or empty
+  };
+
+  // Also raised for malformed timestamps
+  struct InvalidDate : io::error::base,
+                       io::error::with_file_name,
+                       io::error::with_file_line,
+                       io::error::with_column_name,
+                       io::error::with_column_content {
+    void format_error_message() const override {
+      std::snprintf(
+          error_message_buffer, sizeof(error_message_buffer),
+          R"(Expected yyyy-MM-dd date or timestamp, got "%s" in column "%s" in file "%s" in line "%d".)",
+          column_content, column_name, file_name, file_line);
+    }
+  };
+
+  CsvSchema() = default;
+  CsvSchema(std::initializer_list<Field> fields) : fields_(fields) {}
+
+  CsvSchema& Add(std::string name, Type type, bool required = true,
+                 double fallback = 0) {
+    fields_.push_back({std::move(name), type, required, fallback});
+    return *this;
+  }
+
+  [[nodiscard]] size_t Size() const { return fields_.size(); }
+  [[nodiscard]] Field const& operator[](size_t i) const { return fields_[i]; }
+
+  [[nodiscard]] int Find(const char* name) const {
+    for (size_t i = 0; i < fields_.size(); ++i)
+      if (fields_[i].name == name) return static_cast<int>(i);
+    return -1;
+  }
+
+ private:
+  std::vector<Field> fields_;
+};
+
+// Reads the rows of a csv file through a schema. The header maps every file
+// column to a schema field or to nothing, then each line is scanned once for
+// separators: unprojected fields are stepped over without being trimmed or
+// converted and the scan stops after the last projected column, so trailing
+// Open/High/Low/Volume style columns cost only the line split.
+template <class line_reader = io::LineReader>
+class SchemaReader {
+ public:
+  template <class... Args>
+  explicit SchemaReader(CsvSchema schema, Args&&... args)
+      : schema_(std::move(schema)),
+        in_(std::forward<Args>(args)...),
+        values_(schema_.Size()) {
+    ReadHeader();
+  }
+
+  SchemaReader(SchemaReader const&) = delete;
+  SchemaReader(SchemaReader&&) = delete;
+  SchemaReader& operator=(SchemaReader const&) = delete;
+  SchemaReader& operator=(SchemaReader&&) = delete;
+
+  // Parses the next row, returns false at the end of the file
+  bool ReadRow() {
+    try {
+      try {
+        char* line = in_.next_line();
+        if (!line) return false;
+        ParseLine(line);
+      } catch (io::error::with_file_name& err) {
+        err.set_file_name(in_.get_truncated_file_name());
+        throw;
+      }
+    } catch (io::error::with_file_line& err) {
+      err.set_file_line(in_.get_file_line());
+      throw;
+    }
+    return true;
+  }
+
+  [[nodiscard]] CsvSchema const& Schema() const { return schema_; }
+
+  // Whether the file has the column, optional fields may be missing
+  [[nodiscard]] bool Has(size_t field) const { return positions_[field] >= 0; }
+
+  // kDouble fields
+  [[nodiscard]] double GetDouble(size_t field) const {
+    return values_[field].real;
+  }
+
+  // kInt64 fields, kDate fields as days since 1970-01-01 and kTimestamp
+  // fields as nanoseconds since the epoch
+  [[nodiscard]] int64_t GetInt(size_t field) const {
+    return values_[field].integer;
+  }
+
+ private:
+  union Value {
+    double real;
+    int64_t integer;
+  };
+
+  static char* Trim(char*& begin, char* end) {
+    while (begin != end && (*begin == ' ' || *begin == '\t')) ++begin;
+    while (end != begin && (end[-1] == ' ' || end[-1] == '\t')) --end;
+    *end = '\0';
+    return end;
+  }
+
+  void ReadHeader() {
+    char* line = in_.next_line();
+    if (!line) {
+      io::error::header_missing err;
+      err.set_file_name(in_.get_truncated_file_name());
+      throw err;
+    }
+
+    positions_.assign(schema_.Size(), -1);
+    for (int column = 0;; ++column) {
+      char* end = line;
+      while (*end != '\0' && *end != ',') ++end;
+      bool last = *end == '\0';
+      Trim(line, end);
+
+      int field = schema_.Find(line);
+      targets_.push_back(field);
+      if (field >= 0) {
+        if (positions_[field] >= 0) {
+          io::error::duplicated_column_in_header err;
+          err.set_column_name(line);
+          err.set_file_name(in_.get_truncated_file_name());
+          throw err;
+        }
+        positions_[field] = column;
+        last_column_ = column;
+      }
+
+      if (last) break;
+      line = end + 1;
+    }
+
+    for (size_t i = 0; i < schema_.Size(); ++i) {
+      if (positions_[i] < 0 && schema_[i].required) {
+        io::error::missing_column_in_header err;
+        err.set_column_name(schema_[i].name.c_str());
+        err.set_file_name(in_.get_truncated_file_name());
+        throw err;
+      }
+    }
+  }
+
+  void ParseLine(char* line) {
+    int column = 0;
+    for (; column <= last_column_; ++column) {
+      char* end = line;
+      while (*end != '\0' && *end != ',') ++end;
+      bool last = *end == '\0';
+
+      int field = targets_[column];
+      if (field >= 0) Convert(field, line, end);
+
+      if (last) break;
+      line = end + 1;
+    }
+
+    // Short rows are fine as long as only optional fields are cut off
+    for (size_t i = 0; i < schema_.Size(); ++i) {
+      if (positions_[i] >= 0 && positions_[i] <= column) continue;
+      if (schema_[i].required) throw io::error::too_few_columns();
+      SetFallback(i);
+    }
+  }
+
+  void Convert(size_t field, char* begin, char* end) {
+    auto const& spec = schema_[field];
+    Trim(begin, end);
+    if (*begin == '\0' && !spec.required) return SetFallback(field);
+
+    try {
+      try {
+        switch (spec.type) {
+          case CsvSchema::Type::kDouble:
+            io::detail::parse<io::throw_on_overflow>(begin,
+                                                     values_[field].real);
+            break;
+          case CsvSchema::Type::kInt64: {
+            long long value = 0;
+            io::detail::parse<io::throw_on_overflow>(begin, value);
+            values_[field].integer = value;
+            break;
+          }
+          case CsvSchema::Type::kDate:
+            if (!Date::ParseIsoDate(begin, values_[field].integer))
+              throw CsvSchema::InvalidDate();
+            break;
+          case CsvSchema::Type::kTimestamp:
+            if (!Date::ParseTimestamp(begin, values_[field].integer))
+              throw CsvSchema::InvalidDate();
+            break;
+        }
+      } catch (io::error::with_column_content& err) {
+        err.set_column_content(begin);
+        throw;
+      }
+    } catch (io::error::with_column_name& err) {
+      err.set_column_name(spec.name.c_str());
+      throw;
+    }
+  }
+
+  void SetFallback(size_t field) {
+    if (schema_[field].type == CsvSchema::Type::kDouble)
+      values_[field].real = schema_[field].fallback;
+    else
+      values_[field].integer = static_cast<int64_t>(schema_[field].fallback);
+  }
+
+  CsvSchema schema_;
+  line_reader in_;
+  std::vector<Value> values_;
+  std::vector<int> targets_;    // file column -> schema field or -1
+  std::vector<int> positions_;  // schema field -> file column or -1
+  int last_column_ = -1;
+};
+
+#endif  // SRC_MODEL_CSV_SCHEMA_H_
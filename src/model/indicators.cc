@@ -0,0 +1,211 @@
+#include "indicators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace Indicators {
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// Bars per block, every indicator sweeps a block while it is in cache
+constexpr size_t kBlock = 4096;
+
+template <typename... Ts>
+struct Overloaded : Ts... {
+  using Ts::operator()...;
+};
+template <typename... Ts>
+Overloaded(Ts...) -> Overloaded<Ts...>;
+
+}  // namespace
+
+void Sma::Add(double value) {
+  // Neumaier summation
+  double sum = sum_ + value;
+  if (std::fabs(sum_) >= std::fabs(value))
+    compensation_ += (sum_ - sum) + value;
+  else
+    compensation_ += (value - sum) + sum_;
+  sum_ = sum;
+}
+
+double Sma::Update(double value) {
+  if (window_.Full()) Add(-window_.Oldest());
+  Add(value);
+  window_.Push(value);
+  return window_.Full() ? (sum_ + compensation_) / window_.Size() : kNaN;
+}
+
+Ema::Ema(size_t period)
+    : period_(period ? period : 1), alpha_(2.0 / (period_ + 1)) {}
+
+double Ema::Update(double value) {
+  if (count_ < period_) {
+    value_ += (value - value_) / ++count_;
+    return count_ == period_ ? value_ : kNaN;
+  }
+  value_ += alpha_ * (value - value_);
+  return value_;
+}
+
+double Rsi::Update(double value) {
+  if (count_++ == 0) {
+    previous_ = value;
+    return kNaN;
+  }
+
+  double change = value - previous_;
+  previous_ = value;
+
+  // The first period changes are averaged, later ones smoothed by 1 / period
+  size_t changes = count_ - 1;
+  double weight = std::min(changes, period_);
+  gain_ += (std::max(change, 0.0) - gain_) / weight;
+  loss_ += (std::max(-change, 0.0) - loss_) / weight;
+  if (changes < period_) return kNaN;
+
+  if (loss_ == 0) return gain_ == 0 ? 50 : 100;
+  return 100 - 100 / (1 + gain_ / loss_);
+}
+
+Bollinger::Band Bollinger::Update(double value) {
+  if (window_.Full()) {
+    // Replace the oldest bar, mean and m2 move in one step
+    double oldest = window_.Oldest();
+    double mean = mean_ + (value - oldest) / window_.Size();
+    m2_ += (value - oldest) * (value - mean + oldest - mean_);
+    mean_ = mean;
+  } else {
+    double delta = value - mean_;
+    mean_ += delta / (window_.Size() + 1);
+    m2_ += delta * (value - mean_);
+  }
+  window_.Push(value);
+
+  if (!window_.Full()) return {kNaN, kNaN, kNaN};
+  double deviation = std::sqrt(std::max(m2_, 0.0) / window_.Size());
+  return {mean_, mean_ + width_ * deviation, mean_ - width_ * deviation};
+}
+
+double Atr::Update(double high, double low, double close) {
+  // A true range needs the previous close, the first bar only sets it
+  if (count_++ == 0) {
+    previous_ = close;
+    return kNaN;
+  }
+
+  double range = std::max({high - low, std::fabs(high - previous_),
+                           std::fabs(low - previous_)});
+  previous_ = close;
+
+  size_t ranges = count_ - 1;
+  value_ += (range - value_) / std::min(ranges, period_);
+  return ranges < period_ ? kNaN : value_;
+}
+
+std::vector<Output> Engine::Compute(SeriesView const& series) const {
+  std::vector<Output> outputs;
+  std::vector<double*> out;
+  for (auto& name : Lines()) {
+    outputs.push_back({std::move(name), PriceSeries::Column(series.Size())});
+    out.push_back(outputs.back().values.data());
+  }
+
+  Compute(series, out);
+  return outputs;
+}
+
+void Engine::Compute(SeriesView const& series,
+                     std::vector<double*> const& out) const {
+  std::vector<State> states;
+  states.reserve(specs_.size());
+  for (auto const& spec : specs_) states.push_back(MakeState(spec));
+
+  size_t size = series.Size();
+  const double* close = series.values.data();
+  for (size_t begin = 0; begin < size; begin += kBlock) {
+    size_t end = std::min(size, begin + kBlock);
+
+    // Lines are laid out in spec order, Bollinger takes three in a row
+    auto line = out.begin();
+    for (auto& state : states)
+      std::visit(
+          Overloaded{
+              [&](Bollinger& bollinger) {
+                double *middle = *line++, *upper = *line++, *lower = *line++;
+                for (size_t i = begin; i < end; ++i) {
+                  auto band = bollinger.Update(close[i]);
+                  middle[i] = band.middle;
+                  upper[i] = band.upper;
+                  lower[i] = band.lower;
+                }
+              },
+              [&](Atr& atr) {
+                double* values = *line++;
+                for (size_t i = begin; i < end; ++i)
+                  values[i] = atr.Update(close[i], close[i], close[i]);
+              },
+              [&](auto& indicator) {
+                double* values = *line++;
+                for (size_t i = begin; i < end; ++i)
+                  values[i] = indicator.Update(close[i]);
+              }},
+          state);
+  }
+}
+
+std::vector<std::string> Engine::Lines() const {
+  std::vector<std::string> lines;
+  for (auto const& spec : specs_) {
+    std::string name = Name(spec);
+    if (spec.kind == Kind::kBollinger) {
+      for (const char* band : {" middle", " upper", " lower"})
+        lines.push_back(name + band);
+    } else {
+      lines.push_back(std::move(name));
+    }
+  }
+  return lines;
+}
+
+std::string Engine::Name(Spec const& spec) {
+  std::string period = std::to_string(spec.period);
+  switch (spec.kind) {
+    case Kind::kSma:
+      return "SMA(" + period + ")";
+    case Kind::kEma:
+      return "EMA(" + period + ")";
+    case Kind::kRsi:
+      return "RSI(" + period + ")";
+    case Kind::kBollinger: {
+      char width[32];
+      std::snprintf(width, sizeof(width), "%g", spec.width);
+      return "Bollinger(" + period + ", " + width + ")";
+    }
+    case Kind::kAtr:
+      return "ATR(" + period + ")";
+  }
+  return period;
+}
+
+Engine::State Engine::MakeState(Spec const& spec) {
+  switch (spec.kind) {
+    case Kind::kSma:
+      return Sma(spec.period);
+    case Kind::kEma:
+      return Ema(spec.period);
+    case Kind::kRsi:
+      return Rsi(spec.period);
+    case Kind::kBollinger:
+      return Bollinger(spec.period, spec.width);
+    case Kind::kAtr:
+      return Atr(spec.period);
+  }
+  return Sma(spec.period);
+}
+
+}  // namespace Indicators
@@ -0,0 +1,153 @@
+#ifndef SRC_MODEL_INDICATORS_H_
+#define SRC_MODEL_INDICATORS_H_
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "price_series.h"
+#include "span.h"
+
+// Technical indicators updated bar by bar in O(1). Every indicator owns its
+// state in preallocated buffers, so a pass over a series allocates nothing
+// per bar. Update returns NaN until the indicator has seen enough bars.
+namespace Indicators {
+
+// Fixed capacity FIFO over one allocation
+template <typename T>
+class RingBuffer {
+ public:
+  explicit RingBuffer(size_t capacity) : data_(capacity ? capacity : 1) {}
+
+  size_t Size() const noexcept { return size_; }
+  size_t Capacity() const noexcept { return data_.size(); }
+  bool Full() const noexcept { return size_ == data_.size(); }
+  T const& Oldest() const { return data_[head_]; }
+
+  // Appends value, dropping the oldest one once full
+  void Push(T value) {
+    data_[head_] = value;
+    head_ = head_ + 1 == data_.size() ? 0 : head_ + 1;
+    if (size_ < data_.size()) ++size_;
+  }
+
+ private:
+  std::vector<T> data_;
+  size_t head_ = 0, size_ = 0;
+};
+
+// Simple moving average. The running sum is compensated, so adding and
+// removing millions of bars does not drift from the window's true sum.
+class Sma {
+ public:
+  explicit Sma(size_t period) : window_(period) {}
+  double Update(double value);
+
+ private:
+  RingBuffer<double> window_;
+  double sum_ = 0, compensation_ = 0;
+
+  void Add(double value);
+};
+
+// Exponential moving average with alpha = 2 / (period + 1), seeded with the
+// simple average of the first period bars
+class Ema {
+ public:
+  explicit Ema(size_t period);
+  double Update(double value);
+
+ private:
+  size_t period_, count_ = 0;
+  double alpha_, value_ = 0;
+};
+
+// Wilder's relative strength index, 0 to 100
+class Rsi {
+ public:
+  explicit Rsi(size_t period) : period_(period ? period : 1) {}
+  double Update(double value);
+
+ private:
+  size_t period_, count_ = 0;
+  double previous_ = 0, gain_ = 0, loss_ = 0;
+};
+
+// Moving average with bands width standard deviations away. The window's
+// mean and variance are updated Welford style as bars enter and leave, no
+// sum of squares is kept to cancel catastrophically.
+class Bollinger {
+ public:
+  struct Band {
+    double middle, upper, lower;
+  };
+
+  Bollinger(size_t period, double width) : window_(period), width_(width) {}
+  Band Update(double value);
+
+ private:
+  RingBuffer<double> window_;
+  double width_, mean_ = 0, m2_ = 0;
+};
+
+// Wilder's average true range
+class Atr {
+ public:
+  explicit Atr(size_t period) : period_(period ? period : 1) {}
+  double Update(double high, double low, double close);
+
+ private:
+  size_t period_, count_ = 0;
+  double previous_ = 0, value_ = 0;
+};
+
+enum class Kind { kSma, kEma, kRsi, kBollinger, kAtr };
+
+struct Spec {
+  Kind kind;
+  size_t period;
+  double width = 2;  // Bollinger band width in standard deviations
+
+  // Oscillators and ranges are not on the price scale
+  bool OwnScale() const noexcept {
+    return kind == Kind::kRsi || kind == Kind::kAtr;
+  }
+};
+
+struct Output {
+  std::string name;
+  PriceSeries::Column values;
+};
+
+// Computes any number of indicators over a series in a single sweep. Bars
+// are taken in blocks small enough to stay in cache and each indicator runs
+// its block in a tight loop of its own. Compute is const, one engine can
+// serve many series from many threads.
+class Engine {
+ public:
+  explicit Engine(std::vector<Spec> specs) : specs_(std::move(specs)) {}
+
+  // One output per line, Bollinger gives middle, upper and lower. Series
+  // carry closes only, so ranges are measured close to close.
+  [[nodiscard]] std::vector<Output> Compute(SeriesView const& series) const;
+
+  // The same into caller owned columns, one per line and each as long as
+  // the series, so buffers can be reused across series without allocating
+  void Compute(SeriesView const& series, std::vector<double*> const& out) const;
+
+  // Names of the lines Compute writes, in order
+  [[nodiscard]] std::vector<std::string> Lines() const;
+
+  static std::string Name(Spec const& spec);
+
+ private:
+  using State = std::variant<Sma, Ema, Rsi, Bollinger, Atr>;
+
+  std::vector<Spec> specs_;
+
+  static State MakeState(Spec const& spec);
+};
+
+}  // namespace Indicators
+
+#endif  // SRC_MODEL_INDICATORS_H_
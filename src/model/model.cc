@@ -1,61 +1,70 @@
 #include "model.h"
 
-#include <QDate>
-#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <memory>
 
+#include "approximation/barycentric.h"
+#include "approximation/chebyshev.h"
+#include "approximation/hermite.h"
 #include "approximation/least_squares.h"
 #include "approximation/newton.h"
+#include "approximation/smoothing_spline.h"
 #include "approximation/spline.h"
-#include "csv.h"
+#include "approximation/streaming_least_squares.h"
+#include "columnar_writer.h"
+#include "date.h"
+#include "series_loader.h"
 #include "thread_pool.h"
 #include "timer.h"
 #include "utils.h"
 
-Model::GraphData Model::OpenFile(const QString &filename) {
-  io::CSVReader<3> parser(filename.toStdString());
-  parser.read_header(io::ignore_missing_column, "Date", "Close", "Weight");
+PriceSeries const &Model::OpenFile(const QString &filename) {
+  series_ = SeriesLoader::Load(filename.toStdString());
+  return series_;
+}
 
-  keys_.clear();
-  dates_.clear();
-  values_.clear();
-  weights_.clear();
+void Model::SetResolution(int64_t resolution) {
+  series_.SetResolution(resolution > 0 ? resolution
+                                       : series_.CoarsestResolution());
+}
 
-  QDate first_day;
-  double close = 0;
-  std::string date, weight;
-  bool first = true;
+Model::GraphData Model::Newton(size_t points, size_t degree) const {
+  if (IsDataEmpty()) return {};
 
-  while (parser.read_row(date, close, weight)) {
-    if (weight.empty()) weight = "1";
-    QDate day = QDate::fromString(date.c_str(), "yyyy-MM-dd");
+  Interpolation::Newton newton(series_.Keys(), series_.Values(), degree);
+  return CalcGraph(&newton, series_.View(), points);
+}
 
-    if (first) {
-      first_day = day;
-      first = !first;
-    }
+Model::GraphData Model::Spline(size_t points) const {
+  if (IsDataEmpty()) return {};
 
-    dates_.push_back(QDateTime(day, {}).toSecsSinceEpoch());
-    keys_.push_back(first_day.daysTo(day));
-    weights_.push_back(std::stod(weight));
-    values_.push_back(close);
-  }
+  Interpolation::Spline spline(series_.Keys(), series_.Values());
+  return CalcGraph(&spline, series_.View(), points);
+}
 
-  return {QVector<double>(dates_.begin(), dates_.end()),
-          QVector<double>(values_.begin(), values_.end())};
+Model::GraphData Model::Barycentric(size_t points, size_t degree) const {
+  if (IsDataEmpty()) return {};
+
+  Interpolation::Barycentric barycentric(series_.Keys(), series_.Values(),
+                                         degree);
+  return CalcGraph(&barycentric, series_.View(), points);
 }
 
-Model::GraphData Model::Newton(size_t points, size_t degree) const {
+Model::GraphData Model::Pchip(size_t points) const {
   if (IsDataEmpty()) return {};
 
-  Interpolation::Newton newton(keys_, values_, degree);
-  return CalcGraph(&newton, points);
+  Interpolation::Hermite pchip(series_.Keys(), series_.Values(),
+                               Interpolation::Hermite::Method::kPchip);
+  return CalcGraph(&pchip, series_.View(), points);
 }
 
-Model::GraphData Model::Spline(size_t points) const {
+Model::GraphData Model::Akima(size_t points) const {
   if (IsDataEmpty()) return {};
 
-  Interpolation::Spline spline(keys_, values_);
-  return CalcGraph(&spline, points);
+  Interpolation::Hermite akima(series_.Keys(), series_.Values(),
+                               Interpolation::Hermite::Method::kAkima);
+  return CalcGraph(&akima, series_.View(), points);
 }
 
 Model::GraphData Model::Approximate(size_t points,
@@ -63,19 +72,79 @@ Model::GraphData Model::Approximate(size_t points,
                                     size_t days) const {
   if (IsDataEmpty()) return {};
 
-  Approximation::LeastSquares approximation(keys_, values_, weights_, degree);
-  return CalcGraph(&approximation, points, days);
+  Approximation::LeastSquares approximation(
+      series_.Keys(), series_.Values(), series_.Weights(), degree);
+  return CalcGraph(&approximation, series_.View(), points, days);
+}
+
+Model::GraphData Model::Smooth(size_t points, double lambda) const {
+  if (IsDataEmpty()) return {};
+
+  Approximation::SmoothingSpline smoothing(series_.Keys(), series_.Values(),
+                                           series_.Weights(), lambda);
+  return CalcGraph(&smoothing, series_.View(), points);
+}
+
+Model::GraphData Model::Chebyshev(size_t points,
+                                  size_t degree,  //
+                                  size_t days) const {
+  if (IsDataEmpty()) return {};
+
+  Approximation::Chebyshev chebyshev(series_.Keys(), series_.Values(),
+                                     degree);
+  return CalcGraph(&chebyshev, series_.View(), points, days);
+}
+
+Model::Curves Model::CalcIndicators(
+    std::vector<Indicators::Spec> const &specs) const {
+  if (IsDataEmpty()) return {};
+  return CalcIndicators(Indicators::Engine(specs), series_.View());
+}
+
+Model::BacktestData Model::RunBacktest(Backtest::Params const &params) const {
+  if (IsDataEmpty()) return {};
+
+  Backtest::Workspace workspace;
+  auto stats = Backtest::Engine(series_.View()).Run(params, workspace);
+
+  auto dates = series_.Dates();
+  QVector<QCPGraphData> data(static_cast<int>(dates.size()));
+  for (size_t i = 0; i < dates.size(); ++i)
+    data[i] = {dates[i], workspace.equity[i]};
+
+  return {stats, ToGraphData(std::move(data))};
+}
+
+std::vector<Backtest::Stats> Model::SweepBacktest(
+    std::vector<Backtest::Params> const &params) const {
+  if (IsDataEmpty()) return {};
+  return Backtest::Engine(series_.View()).Sweep(params);
+}
+
+Model::GraphData Model::ApproximateFile(const QString &filename,
+                                        size_t points,
+                                        size_t degree,  //
+                                        size_t days) {
+  Approximation::StreamingLeastSquares approximation(degree);
+  PriceSeries bounds = SeriesLoader::Stream(
+      filename.toStdString(), [&](SeriesView const &chunk) {
+        approximation.Add(chunk.keys, chunk.values, chunk.weights);
+      });
+
+  approximation.Fit();
+  return CalcGraph(&approximation, bounds.View(), points, days);
 }
 
 std::tuple<double, double>  //
 Model::FindInterpolationValue(double x, size_t degree) const {
-  if (IsDataEmpty() || !(dates_.front() <= x && x <= dates_.back()))
+  if (IsDataEmpty() ||
+      !(series_.Dates().front() <= x && x <= series_.Dates().back()))
     return {qQNaN(), qQNaN()};
 
   x = DateToKey(x);
 
-  Interpolation::Newton newton(keys_, values_, degree);
-  Interpolation::Spline spline(keys_, values_);
+  Interpolation::Newton newton(series_.Keys(), series_.Values(), degree);
+  Interpolation::Spline spline(series_.Keys(), series_.Values());
 
   return {newton.GetValue(x), spline.GetValue(x)};
 }
@@ -85,24 +154,64 @@ double Model::FindApproximationValue(double x, size_t degree) const {
 
   x = DateToKey(x);
 
-  Approximation::LeastSquares approximation(keys_, values_, weights_, degree);
+  Approximation::LeastSquares approximation(
+      series_.Keys(), series_.Values(), series_.Weights(), degree);
   return approximation.GetValue(x);
 }
 
-std::tuple<QVector<double>, QVector<double>, QVector<double>>
+void Model::Export(const QString &filename, Curves const &curves,
+                   size_t max_degree) const {
+  ColumnarWriter writer;
+  writer.AddTable("series",
+                  {ColumnarWriter::Int64("timestamp", series_.Timestamps()),
+                   ColumnarWriter::Float64("key", series_.Keys()),
+                   ColumnarWriter::Float64("close", series_.Values()),
+                   ColumnarWriter::Float64("weight", series_.Weights())});
+
+  // QCPGraphData keeps keys and values interleaved, read them with a stride
+  for (auto const &[name, data] : curves) {
+    if (!data || data->isEmpty()) continue;
+    const QCPGraphData *points = &*data->constBegin();
+    size_t size = data->size();
+    writer.AddTable(
+        name, {ColumnarWriter::Float64("key", &points->key, size,
+                                       sizeof(QCPGraphData)),
+               ColumnarWriter::Float64("value", &points->value, size,
+                                       sizeof(QCPGraphData))});
+  }
+
+  // Fits have to stay alive until the file is written
+  std::vector<std::unique_ptr<Approximation::LeastSquares>> fits;
+  for (size_t degree = 1; !IsDataEmpty() && degree <= max_degree; ++degree) {
+    fits.push_back(std::make_unique<Approximation::LeastSquares>(
+        series_.Keys(), series_.Values(), series_.Weights(), degree));
+    writer.AddTable(
+        "least_squares_" + std::to_string(degree),
+        {ColumnarWriter::Float64("coefficient", fits.back()->Coefs())});
+  }
+
+  writer.Write(filename.toStdString());
+}
+
+Portfolio const &Model::OpenFiles(const QString &pattern) {
+  portfolio_.Load(SeriesLoader::Expand(pattern.toStdString()));
+  return portfolio_;
+}
+
+Model::InterpolationResearchData  //
 Model::InterpolationResearch(size_t points, size_t partitions,
                              size_t degree) const {
   if (IsDataEmpty()) return {};
 
-  size_t step = Utils::CalcStep(points - keys_.size(), partitions - 1);
+  size_t step = Utils::CalcStep(points - series_.Size(), partitions - 1);
 
   if (step == 0) partitions = 2;
-  if (points == keys_.size()) partitions = 1;
+  if (points == series_.Size()) partitions = 1;
 
-  QVector<double> keys(partitions), newton(partitions), spline(partitions);
+  std::vector<size_t> keys(partitions);
 
   for (size_t i = 0; i < partitions; ++i)
-    keys[i] = (i == partitions - 1) ? points : (keys_.size() + i * step);
+    keys[i] = (i == partitions - 1) ? points : (series_.Size() + i * step);
 
   ThreadPool pool;
   const size_t k_count = 10;
@@ -128,68 +237,205 @@ Model::InterpolationResearch(size_t points, size_t partitions,
 
   pool.WaitAll();
 
+  QVector<QCPGraphData> newton(partitions), spline(partitions);
   for (size_t i = 0; i < partitions; ++i) {
+    newton[i].key = spline[i].key = keys[i];
     for (size_t j = 0; j < k_count; ++j) {
-      newton[i] += time1(i, j);
-      spline[i] += time2(i, j);
+      newton[i].value += time1(i, j);
+      spline[i].value += time2(i, j);
     }
-    newton[i] /= k_count;
-    spline[i] /= k_count;
+    newton[i].value /= k_count;
+    spline[i].value /= k_count;
   }
 
-  return {std::move(keys), std::move(newton), std::move(spline)};
+  return {ToGraphData(std::move(newton)), ToGraphData(std::move(spline))};
 }
 
 Model::ApproximationResearchData  //
 Model::ApproximationResearch(size_t points, size_t days) {
   if (IsDataEmpty()) return {};
 
-  std::vector<double> tmp_weights(weights_.size(), 1);
-
-  Approximation::LeastSquares app_1(keys_, values_, weights_, 1);
-  Approximation::LeastSquares app_2(keys_, values_, weights_, 2);
-  Approximation::LeastSquares app_3(keys_, values_, tmp_weights, 1);
-  Approximation::LeastSquares app_4(keys_, values_, tmp_weights, 2);
-
-  auto [keys_1, values_1] = CalcGraph(&app_1, points, days);
-  auto [keys_2, values_2] = CalcGraph(&app_2, points, days);
-  auto [keys_3, values_3] = CalcGraph(&app_3, points, days);
-  auto [keys_4, values_4] = CalcGraph(&app_4, points, days);
-
-  return {std::move(keys_1),    //
-          std::move(values_1),  //
-          std::move(values_2),  //
-          std::move(values_3),  //
-          std::move(values_4)};
-}
-
-std::tuple<QVector<double>, QVector<double>>  //
-Model::CalcGraph(BaseApproximation *method, size_t points, size_t days) const {
-  double first_key = keys_.front();
-  double last_key = keys_.back() + days;
-  double first_date = dates_.front();
-  double last_date = QDateTime::fromSecsSinceEpoch(dates_.back())
-                         .addDays(days)
-                         .toSecsSinceEpoch();
+  auto keys = series_.Keys(), values = series_.Values();
+  std::vector<double> tmp_weights(series_.Size(), 1);
+
+  Approximation::LeastSquares app_1(keys, values, series_.Weights(), 1);
+  Approximation::LeastSquares app_2(keys, values, series_.Weights(), 2);
+  Approximation::LeastSquares app_3(keys, values, tmp_weights, 1);
+  Approximation::LeastSquares app_4(keys, values, tmp_weights, 2);
+
+  auto series = series_.View();
+  return {CalcGraph(&app_1, series, points, days),
+          CalcGraph(&app_2, series, points, days),
+          CalcGraph(&app_3, series, points, days),
+          CalcGraph(&app_4, series, points, days)};
+}
+
+Model::PortfolioData Model::PortfolioNewton(size_t points,
+                                            size_t degree) const {
+  return FitPortfolio([=](SeriesView const &series) {
+    Interpolation::Newton newton(series.keys, series.values, degree);
+    return CalcGraph(&newton, series, points);
+  });
+}
+
+Model::PortfolioData Model::PortfolioSpline(size_t points) const {
+  return FitPortfolio([=](SeriesView const &series) {
+    Interpolation::Spline spline(series.keys, series.values);
+    return CalcGraph(&spline, series, points);
+  });
+}
+
+Model::PortfolioData Model::PortfolioBarycentric(size_t points,
+                                                 size_t degree) const {
+  return FitPortfolio([=](SeriesView const &series) {
+    Interpolation::Barycentric barycentric(series.keys, series.values,
+                                           degree);
+    return CalcGraph(&barycentric, series, points);
+  });
+}
+
+Model::PortfolioData Model::PortfolioPchip(size_t points) const {
+  return FitPortfolio([=](SeriesView const &series) {
+    // Portfolio::ForEach already runs symbols on a pool of its own
+    Interpolation::Hermite pchip(series.keys, series.values,
+                                 Interpolation::Hermite::Method::kPchip,
+                                 false);
+    return CalcGraph(&pchip, series, points);
+  });
+}
+
+Model::PortfolioData Model::PortfolioAkima(size_t points) const {
+  return FitPortfolio([=](SeriesView const &series) {
+    Interpolation::Hermite akima(series.keys, series.values,
+                                 Interpolation::Hermite::Method::kAkima,
+                                 false);
+    return CalcGraph(&akima, series, points);
+  });
+}
+
+Model::PortfolioData Model::PortfolioApproximate(size_t points,
+                                                 size_t degree,  //
+                                                 size_t days) const {
+  return FitPortfolio([=](SeriesView const &series) {
+    Approximation::LeastSquares approximation(series.keys, series.values,
+                                              series.weights, degree);
+    return CalcGraph(&approximation, series, points, days);
+  });
+}
+
+Model::PortfolioData Model::PortfolioSmooth(size_t points,
+                                            double lambda) const {
+  return FitPortfolio([=](SeriesView const &series) {
+    Approximation::SmoothingSpline smoothing(series.keys, series.values,
+                                             series.weights, lambda);
+    return CalcGraph(&smoothing, series, points);
+  });
+}
+
+Model::PortfolioData Model::PortfolioChebyshev(size_t points,
+                                               size_t degree,  //
+                                               size_t days) const {
+  return FitPortfolio([=](SeriesView const &series) {
+    Approximation::Chebyshev chebyshev(series.keys, series.values, degree);
+    return CalcGraph(&chebyshev, series, points, days);
+  });
+}
+
+std::vector<std::pair<std::string, Model::Curves>>  //
+Model::PortfolioIndicators(std::vector<Indicators::Spec> const &specs) const {
+  Indicators::Engine engine(specs);
+  std::vector<std::pair<std::string, Curves>> result(portfolio_.Size());
+  portfolio_.ForEach([&](size_t i, SeriesView const &series) {
+    result[i] = {portfolio_.Symbols()[i].name, CalcIndicators(engine, series)};
+  });
+  return result;
+}
+
+std::vector<std::pair<std::string, Backtest::Stats>>  //
+Model::PortfolioBacktest(Backtest::Params const &params) const {
+  std::vector<std::pair<std::string, Backtest::Stats>> result(
+      portfolio_.Size());
+  portfolio_.ForEach([&](size_t i, SeriesView const &series) {
+    Backtest::Workspace workspace;
+    result[i] = {portfolio_.Symbols()[i].name,
+                 Backtest::Engine(series).Run(params, workspace)};
+  });
+  return result;
+}
+
+template <typename Fit>
+Model::PortfolioData Model::FitPortfolio(Fit const &fit) const {
+  PortfolioData result(portfolio_.Size());
+  portfolio_.ForEach([&](size_t i, SeriesView const &series) {
+    result[i] = {portfolio_.Symbols()[i].name, fit(series)};
+  });
+  return result;
+}
+
+Model::GraphData Model::CalcGraph(BaseApproximation *method,
+                                  SeriesView const &series, size_t points,
+                                  size_t days) {
+  if (series.Empty()) return {};
+
+  // Keys count resolution units, so dates follow from them without calendar
+  // lookups and the forecast horizon converts from days the same way
+  double key_seconds = double(series.resolution) / Date::kNanosPerSecond;
+  double first_key = series.keys.front();
+  double last_key =
+      series.keys.back() + days * (Date::kSecondsPerDay / key_seconds);
+  double first_date = series.dates.front();
   double step_key = Utils::CalcStep(last_key - first_key, points);
-  double step_date = Utils::CalcStep(last_date - first_date, points);
+  double step_date = step_key * key_seconds;
+
+  if (step_key <= 0) points = 0;
+
+  // Evaluated in blocks so batch kernels see many points per call
+  constexpr size_t kBlock = 1024;
+  double keys[kBlock], values[kBlock];
+
+  QVector<QCPGraphData> data(points);
+  for (size_t begin = 0; begin < points; begin += kBlock) {
+    size_t count = std::min(kBlock, points - begin);
+    for (size_t i = 0; i < count; ++i)
+      keys[i] = first_key + (begin + i) * step_key;
 
-  QVector<double> keys, values;
-  while (first_key < last_key) {
-    keys.push_back(first_date);
-    values.push_back(method->GetValue(first_key));
-    first_key += step_key, first_date += step_date;
+    method->GetValues({keys, count}, values);
+    for (size_t i = 0; i < count; ++i)
+      data[begin + i] = {first_date + (begin + i) * step_date, values[i]};
   }
 
-  return {std::move(keys), std::move(values)};
+  return ToGraphData(std::move(data));
+}
+
+Model::GraphData Model::ToGraphData(QVector<QCPGraphData> &&data) {
+  // QVector is implicitly shared, so set() adopts the buffer instead of
+  // copying it, and the keys are generated in ascending order already
+  GraphData graph(new QCPGraphDataContainer);
+  graph->set(data, true);
+  return graph;
+}
+
+Model::Curves Model::CalcIndicators(Indicators::Engine const &engine,
+                                    SeriesView const &series) {
+  Curves curves;
+  auto outputs = engine.Compute(series);
+  for (auto &[name, values] : outputs) {
+    QVector<QCPGraphData> data;
+    data.reserve(static_cast<int>(values.size()));
+    for (size_t i = 0; i < values.size(); ++i)
+      if (!std::isnan(values[i])) data.push_back({series.dates[i], values[i]});
+
+    curves.emplace_back(std::move(name), ToGraphData(std::move(data)));
+  }
+  return curves;
 }
 
 double Model::DateToKey(double date) const {
-  QDate first_day = QDateTime::fromSecsSinceEpoch(dates_.front()).date();
-  QDate day = QDateTime::fromSecsSinceEpoch(date).date();
-  return first_day.daysTo(day);
+  double key_seconds = double(series_.Resolution()) / Date::kNanosPerSecond;
+  double units = (date - series_.Dates().front()) / key_seconds;
+  return series_.Keys().front() + std::floor(units);
 }
 
 bool Model::IsDataEmpty() const noexcept {
-  return keys_.empty() || values_.empty() || dates_.empty();
+  return series_.Empty();
 }
@@ -1,26 +1,66 @@
 #ifndef SRC_MODEL_MODEL_H_
 #define SRC_MODEL_MODEL_H_
 
-#include <QVector>
+#include <QSharedPointer>
+#include <string>
 #include <vector>
 
 #include "approximation/base_approximation.h"
+#include "backtest.h"
+#include "indicators.h"
+#include "portfolio.h"
+#include "price_series.h"
+#include "qcustomplot.h"
 
 class Model {
  public:
-  using GraphData = std::tuple<QVector<double>, QVector<double>>;
-  using InterpolationResearchData =
-      std::tuple<QVector<double>, QVector<double>, QVector<double>>;
+  // Sorted, ready to adopt with QCPGraph::setData without copying
+  using GraphData = QSharedPointer<QCPGraphDataContainer>;
+  using InterpolationResearchData = std::tuple<GraphData, GraphData>;
   using ApproximationResearchData =
-      std::tuple<QVector<double>, QVector<double>, QVector<double>,
-                 QVector<double>, QVector<double>>;
+      std::tuple<GraphData, GraphData, GraphData, GraphData>;
+  using PortfolioData = std::vector<std::pair<std::string, GraphData>>;
+  using Curves = std::vector<std::pair<std::string, GraphData>>;
+  using BacktestData = std::tuple<Backtest::Stats, GraphData>;
 
-  [[nodiscard]] GraphData OpenFile(const QString& filename);
+  [[nodiscard]] PriceSeries const& OpenFile(const QString& filename);
+  // Nanoseconds per key unit of the open series, 0 picks the coarsest unit
+  // that keeps every row on its own key
+  void SetResolution(int64_t resolution);
   [[maybe_unused]] GraphData Newton(size_t points, size_t degree) const;
   [[maybe_unused]] GraphData Spline(size_t points) const;
+  [[nodiscard]] GraphData Barycentric(size_t points, size_t degree) const;
+  [[nodiscard]] GraphData Pchip(size_t points) const;
+  [[nodiscard]] GraphData Akima(size_t points) const;
   [[nodiscard]] GraphData Approximate(size_t points,
                                       size_t degree,  //
                                       size_t days) const;
+  // Smoothing spline weighted by the Weight column, lambda >= 0 trades
+  // closeness to the data for smoothness
+  [[nodiscard]] GraphData Smooth(size_t points, double lambda) const;
+  // Truncated Chebyshev series, stable at degrees where Approximate is not
+  [[nodiscard]] GraphData Chebyshev(size_t points,
+                                    size_t degree,  //
+                                    size_t days) const;
+
+  // Every indicator line over the open series in one pass, warm-up bars
+  // without a value are left out
+  [[nodiscard]] Curves CalcIndicators(
+      std::vector<Indicators::Spec> const& specs) const;
+
+  // Trades the forecast over the open series, the graph is the cumulative
+  // P&L after every bar
+  [[nodiscard]] BacktestData RunBacktest(Backtest::Params const& params) const;
+  [[nodiscard]] std::vector<Backtest::Stats> SweepBacktest(
+      std::vector<Backtest::Params> const& params) const;
+
+  // Fits the file in one streaming pass without loading it, for series too
+  // large for memory. Independent of the open series. Keys use the unit
+  // of the first rows, a file that turns finer later on throws.
+  [[nodiscard]] static GraphData ApproximateFile(const QString& filename,
+                                                 size_t points,
+                                                 size_t degree,  //
+                                                 size_t days);
 
   [[nodiscard]] InterpolationResearchData  //
   InterpolationResearch(size_t points, size_t partitions, size_t degree) const;
@@ -33,15 +73,49 @@ class Model {
 
   [[nodiscard]] double FindApproximationValue(double x, size_t degree) const;
 
+  // Writes the open series, the given curves and least squares coefficients
+  // for degrees 1 to max_degree to a columnar binary file
+  void Export(const QString& filename, Curves const& curves,
+              size_t max_degree) const;
+
+  [[nodiscard]] Portfolio const& OpenFiles(const QString& pattern);
+  [[nodiscard]] PortfolioData PortfolioNewton(size_t points,
+                                              size_t degree) const;
+  [[nodiscard]] PortfolioData PortfolioSpline(size_t points) const;
+  [[nodiscard]] PortfolioData PortfolioBarycentric(size_t points,
+                                                   size_t degree) const;
+  [[nodiscard]] PortfolioData PortfolioPchip(size_t points) const;
+  [[nodiscard]] PortfolioData PortfolioAkima(size_t points) const;
+  [[nodiscard]] PortfolioData PortfolioApproximate(size_t points,
+                                                   size_t degree,  //
+                                                   size_t days) const;
+  [[nodiscard]] PortfolioData PortfolioSmooth(size_t points,
+                                              double lambda) const;
+  [[nodiscard]] PortfolioData PortfolioChebyshev(size_t points,
+                                                 size_t degree,  //
+                                                 size_t days) const;
+  [[nodiscard]] std::vector<std::pair<std::string, Curves>>  //
+  PortfolioIndicators(std::vector<Indicators::Spec> const& specs) const;
+  [[nodiscard]] std::vector<std::pair<std::string, Backtest::Stats>>  //
+  PortfolioBacktest(Backtest::Params const& params) const;
+
  private:
-  std::vector<double> keys_, values_, weights_, dates_;
+  PriceSeries series_;
+  Portfolio portfolio_;
 
   double DateToKey(double date) const;
   bool IsDataEmpty() const noexcept;
 
-  [[nodiscard]] GraphData CalcGraph(BaseApproximation* method,
-                                    size_t points,  //
-                                    size_t days = 0) const;
+  template <typename Fit>
+  [[nodiscard]] PortfolioData FitPortfolio(Fit const& fit) const;
+
+  [[nodiscard]] static GraphData CalcGraph(BaseApproximation* method,
+                                           SeriesView const& series,
+                                           size_t points,  //
+                                           size_t days = 0);
+  static GraphData ToGraphData(QVector<QCPGraphData>&& data);
+  static Curves CalcIndicators(Indicators::Engine const& engine,
+                               SeriesView const& series);
 };
 
 #endif  // SRC_MODEL_MODEL_H_
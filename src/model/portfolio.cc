@@ -0,0 +1,43 @@
+#include "portfolio.h"
+
+#include "timer.h"
+
+void Portfolio::Load(std::vector<std::string> const &filenames) {
+  Timer timer;
+  std::vector<SeriesLoader::FileStats> stats;
+  auto parts = SeriesLoader::LoadMany(filenames, &stats);
+
+  size_t rows = 0;
+  for (auto &part : parts) rows += part.Size();
+
+  PriceSeries store;
+  std::vector<Symbol> symbols;
+  store.Reserve(rows);
+  symbols.reserve(parts.size());
+
+  for (size_t i = 0; i < parts.size(); ++i) {
+    auto name = SeriesLoader::Symbol(filenames[i]);
+    symbols.push_back({std::move(name), store.Size(), parts[i].Size(),
+                       parts[i].Resolution()});
+    store.Append(parts[i]);
+  }
+
+  store_ = std::move(store);
+  symbols_ = std::move(symbols);
+  stats_ = std::move(stats);
+  load_seconds_ = timer.FinishSeconds();
+}
+
+void Portfolio::Clear() noexcept {
+  store_.Clear();
+  symbols_.clear();
+  stats_.clear();
+  load_seconds_ = 0;
+}
+
+SeriesView Portfolio::Series(size_t index) const {
+  auto const &symbol = symbols_.at(index);
+  auto series = store_.Slice(symbol.offset, symbol.size);
+  series.resolution = symbol.resolution;
+  return series;
+}
@@ -0,0 +1,67 @@
+#ifndef SRC_MODEL_PORTFOLIO_H_
+#define SRC_MODEL_PORTFOLIO_H_
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "price_series.h"
+#include "series_loader.h"
+#include "thread_pool.h"
+
+// Many symbols kept back to back in a single columnar store. Each symbol is
+// a row range of the shared columns, so per-symbol work reads plain spans.
+class Portfolio {
+ public:
+  struct Symbol {
+    std::string name;
+    size_t offset, size;
+    int64_t resolution;  // nanoseconds per key unit of this symbol
+  };
+
+  void Load(std::vector<std::string> const& filenames);
+  void Clear() noexcept;
+
+  size_t Size() const noexcept { return symbols_.size(); }
+  bool Empty() const noexcept { return symbols_.empty(); }
+  std::vector<Symbol> const& Symbols() const noexcept { return symbols_; }
+  SeriesView Series(size_t index) const;
+
+  // Per-file read and parse timings and wall time of the last Load
+  std::vector<SeriesLoader::FileStats> const& Stats() const noexcept {
+    return stats_;
+  }
+  double LoadSeconds() const noexcept { return load_seconds_; }
+
+  // Calls func(index, series) for every symbol in parallel
+  template <typename Func>
+  void ForEach(Func const& func) const;
+
+ private:
+  PriceSeries store_;
+  std::vector<Symbol> symbols_;
+  std::vector<SeriesLoader::FileStats> stats_;
+  double load_seconds_ = 0;
+};
+
+template <typename Func>
+void Portfolio::ForEach(Func const& func) const {
+  std::vector<std::exception_ptr> errors(Size());
+
+  ThreadPool pool;
+  for (size_t i = 0; i < Size(); ++i) {
+    pool.AddTask([&, i] {
+      try {
+        func(i, Series(i));
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
+  pool.WaitAll();
+
+  for (auto& error : errors)
+    if (error) std::rethrow_exception(error);
+}
+
+#endif  // SRC_MODEL_PORTFOLIO_H_
@@ -0,0 +1,91 @@
+#include "price_series.h"
+
+#include <filesystem>
+#include <numeric>
+
+void PriceSeries::Reserve(size_t rows) {
+  timestamps_.reserve(rows);
+  dates_.reserve(rows);
+  keys_.reserve(rows);
+  values_.reserve(rows);
+  weights_.reserve(rows);
+}
+
+void PriceSeries::ReserveForFile(std::string const& filename) {
+  Reserve(EstimateRows(filename));
+}
+
+void PriceSeries::Clear() noexcept {
+  timestamps_.clear();
+  dates_.clear();
+  keys_.clear();
+  values_.clear();
+  weights_.clear();
+}
+
+void PriceSeries::PushBack(int64_t timestamp, double value, double weight) {
+  timestamps_.push_back(timestamp);
+  dates_.push_back(static_cast<double>(timestamp) / Date::kNanosPerSecond);
+  keys_.push_back(KeyOf(timestamp));
+  values_.push_back(value);
+  weights_.push_back(weight);
+}
+
+void PriceSeries::Append(PriceSeries const& other) {
+  timestamps_.insert(timestamps_.end(), other.timestamps_.begin(),
+                     other.timestamps_.end());
+  dates_.insert(dates_.end(), other.dates_.begin(), other.dates_.end());
+  keys_.insert(keys_.end(), other.keys_.begin(), other.keys_.end());
+  values_.insert(values_.end(), other.values_.begin(), other.values_.end());
+  weights_.insert(weights_.end(), other.weights_.begin(), other.weights_.end());
+}
+
+void PriceSeries::SetResolution(int64_t resolution) {
+  if (resolution <= 0 || resolution == resolution_) return;
+
+  resolution_ = resolution;
+  for (size_t i = 0; i < keys_.size(); ++i) keys_[i] = KeyOf(timestamps_[i]);
+}
+
+void PriceSeries::SetOrigin(int64_t origin) {
+  origin_ = origin;
+  has_origin_ = true;
+  for (size_t i = 0; i < keys_.size(); ++i) keys_[i] = KeyOf(timestamps_[i]);
+}
+
+int64_t PriceSeries::CoarsestResolution() const {
+  int64_t gaps = 0;
+  for (size_t i = 1; i < timestamps_.size() && gaps != 1; ++i)
+    gaps = std::gcd(gaps, timestamps_[i] - timestamps_[0]);
+
+  for (int64_t unit : {Date::kNanosPerDay, Date::kNanosPerHour,
+                       Date::kNanosPerMinute, Date::kNanosPerSecond,
+                       Date::kNanosPerSecond / 1000,
+                       Date::kNanosPerSecond / 1000000})
+    if (gaps % unit == 0) return unit;
+  return 1;
+}
+
+SeriesView PriceSeries::Slice(size_t offset, size_t count) const {
+  return {Timestamps().Subspan(offset, count), Dates().Subspan(offset, count),
+          Keys().Subspan(offset, count), Values().Subspan(offset, count),
+          Weights().Subspan(offset, count), resolution_};
+}
+
+double PriceSeries::KeyOf(int64_t timestamp) const {
+  // Integer difference first, the epoch offset itself is not exact in double
+  int64_t origin = has_origin_ ? origin_ : timestamps_.front();
+  return static_cast<double>(timestamp - origin) / resolution_;
+}
+
+size_t PriceSeries::EstimateRows(std::string const& filename) {
+  std::error_code error;
+  uintmax_t bytes = std::filesystem::file_size(filename, error);
+  return error ? 0 : EstimateRows(bytes);
+}
+
+size_t PriceSeries::EstimateRows(uintmax_t bytes) {
+  // Shortest realistic row is "yyyy-MM-dd,x\n", so this never underestimates
+  constexpr uintmax_t kMinRowBytes = 13;
+  return bytes / kMinRowBytes + 1;
+}
@@ -0,0 +1,78 @@
+#ifndef SRC_MODEL_PRICE_SERIES_H_
+#define SRC_MODEL_PRICE_SERIES_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "date.h"
+#include "span.h"
+
+// Read-only window over a contiguous run of PriceSeries rows
+struct SeriesView {
+  Span<const int64_t> timestamps;
+  Span<const double> dates, keys, values, weights;
+  int64_t resolution = Date::kNanosPerDay;  // nanoseconds per key unit
+
+  size_t Size() const noexcept { return keys.size(); }
+  bool Empty() const noexcept { return keys.empty(); }
+};
+
+// Structure-of-arrays storage for a loaded price history. Every column is a
+// contiguous, cache line aligned array, so engines and the plotting layer
+// read them through Span views without any intermediate copies.
+//
+// Rows are stamped with epoch nanoseconds. Dates holds the same instants as
+// seconds for plotting, keys count resolution units from the first row, so
+// intraday bars get distinct keys instead of collapsing onto their day.
+class PriceSeries {
+ public:
+  using Column = std::vector<double, AlignedAllocator<double>>;
+  using IntColumn = std::vector<int64_t, AlignedAllocator<int64_t>>;
+
+  void Reserve(size_t rows);
+  void ReserveForFile(std::string const& filename);
+  void Clear() noexcept;
+  void PushBack(int64_t timestamp, double value, double weight);
+  // Keys of other are copied as is, they stay relative to its first row
+  void Append(PriceSeries const& other);
+
+  // Re-derives keys, nanoseconds per key unit
+  void SetResolution(int64_t resolution);
+  int64_t Resolution() const noexcept { return resolution_; }
+
+  // Pins the timestamp of key 0, which is otherwise the first row. Kept
+  // across Clear, so chunks of one long series share their keys.
+  void SetOrigin(int64_t origin);
+
+  // Largest of a day, hour, minute, second, millisecond or microsecond that
+  // divides every gap between timestamps, one nanosecond if none does
+  int64_t CoarsestResolution() const;
+
+  size_t Size() const noexcept { return keys_.size(); }
+  bool Empty() const noexcept { return keys_.empty(); }
+
+  Span<const int64_t> Timestamps() const { return timestamps_; }
+  Span<const double> Dates() const { return dates_; }
+  Span<const double> Keys() const { return keys_; }
+  Span<const double> Values() const { return values_; }
+  Span<const double> Weights() const { return weights_; }
+
+  SeriesView View() const { return Slice(0, Size()); }
+  SeriesView Slice(size_t offset, size_t count) const;
+
+  static size_t EstimateRows(std::string const& filename);
+  static size_t EstimateRows(uintmax_t bytes);
+
+ private:
+  double KeyOf(int64_t timestamp) const;
+
+  IntColumn timestamps_;
+  Column dates_, keys_, values_, weights_;
+  int64_t resolution_ = Date::kNanosPerDay;
+  int64_t origin_ = 0;
+  bool has_origin_ = false;
+};
+
+#endif  // SRC_MODEL_PRICE_SERIES_H_
@@ -0,0 +1,276 @@
+#include "series_loader.h"
+
+#include <glob.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+
+#include "compressed_source.h"
+#include "csv.h"
+#include "csv_schema.h"
+#include "date.h"
+#include "thread_pool.h"
+#include "timer.h"
+
+namespace {
+
+// Only these columns are converted, anything else in the file is skipped
+enum PriceField { kDate, kClose, kWeight };
+
+CsvSchema const &PriceSchema() {
+  static const CsvSchema schema{
+      {"Date", CsvSchema::Type::kTimestamp},
+      {"Close", CsvSchema::Type::kDouble},
+      {"Weight", CsvSchema::Type::kDouble, false, 1},
+  };
+  return schema;
+}
+
+template <typename Reader>
+PriceSeries ReadRows(Reader &reader, size_t rows) {
+  PriceSeries series;
+  series.Reserve(rows);
+
+  while (reader.ReadRow())
+    series.PushBack(reader.GetInt(kDate), reader.GetDouble(kClose),
+                    reader.GetDouble(kWeight));
+
+  // Keys are days until here, refine them if the rows are intraday
+  series.SetResolution(series.CoarsestResolution());
+  return series;
+}
+
+std::string ReadFile(std::string const &filename) {
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file) {
+    io::error::can_not_open_file err;
+    err.set_errno(errno);
+    err.set_file_name(filename.c_str());
+    throw err;
+  }
+
+  std::string buffer(static_cast<size_t>(file.tellg()), '\0');
+  file.seekg(0);
+  file.read(buffer.data(), buffer.size());
+  return buffer;
+}
+
+// Calls func(reader, rows) with a schema reader over the file, a pipelined
+// one for large files, inflating it on the way if it is compressed
+template <typename Func>
+PriceSeries WithReader(std::string const &filename, Func const &func) {
+  // Splitting lines on a second thread only pays off on large files
+  constexpr uintmax_t kPipelineThreshold = 16 * CSV_IO_BLOCK_LEN;
+
+  std::error_code error;
+  auto format = CompressedSource::Detect(filename);
+  uintmax_t bytes = CompressedSource::EstimateBytes(
+      std::filesystem::file_size(filename, error), format);
+  size_t rows = PriceSeries::EstimateRows(bytes);
+  bool pipelined = !error && bytes > kPipelineThreshold;
+
+  if (format != CompressedSource::Format::kNone) {
+    auto source = std::make_unique<CompressedSource>(filename, format);
+    if (pipelined) {
+      SchemaReader<io::PipelinedLineReader> reader(PriceSchema(), filename,
+                                                   std::move(source));
+      return func(reader, rows);
+    }
+    SchemaReader<> reader(PriceSchema(), filename, std::move(source));
+    return func(reader, rows);
+  }
+
+  if (pipelined) {
+    SchemaReader<io::PipelinedLineReader> reader(PriceSchema(), filename);
+    return func(reader, rows);
+  }
+
+  SchemaReader<> reader(PriceSchema(), filename);
+  return func(reader, rows);
+}
+
+// Length of the csv suffix filename ends in, plain or compressed, 0 if none
+size_t CsvSuffix(std::string const &filename) {
+  for (const char *suffix : {".csv", ".csv.gz", ".csv.zst"}) {
+    size_t length = std::strlen(suffix);
+    if (filename.size() >= length &&
+        filename.compare(filename.size() - length, length, suffix) == 0)
+      return length;
+  }
+  return 0;
+}
+
+bool IsCsv(std::string const &filename) { return CsvSuffix(filename) > 0; }
+
+}  // namespace
+
+double SeriesLoader::FileStats::MegabytesPerSecond() const {
+  double seconds = read_seconds + parse_seconds;
+  return seconds > 0 ? bytes / seconds / (1 << 20) : 0;
+}
+
+double SeriesLoader::FileStats::RowsPerSecond() const {
+  double seconds = read_seconds + parse_seconds;
+  return seconds > 0 ? rows / seconds : 0;
+}
+
+PriceSeries SeriesLoader::Load(std::string const &filename) {
+  return WithReader(filename, [](auto &reader, size_t rows) {
+    return ReadRows(reader, rows);
+  });
+}
+
+PriceSeries SeriesLoader::Stream(std::string const &filename,
+                                 ChunkFunc const &func, int64_t resolution,
+                                 size_t chunk_rows) {
+  return WithReader(filename, [&](auto &reader, size_t) {
+    PriceSeries chunk, bounds;
+    chunk.SetResolution(resolution);
+    bounds.SetResolution(resolution);
+    chunk.Reserve(std::max<size_t>(chunk_rows, 1));
+
+    // Until the unit is known the first chunk is held back, its keys are
+    // re-derived before anyone sees them
+    bool detect = resolution <= 0;
+    auto flush = [&] {
+      if (resolution <= 0) {
+        resolution = chunk.CoarsestResolution();
+        chunk.SetResolution(resolution);
+        bounds.SetResolution(resolution);
+      }
+      func(chunk.View());
+      chunk.Clear();
+    };
+
+    int64_t timestamp = 0, origin = 0;
+    double close = 0, weight = 0;
+    size_t row = 0;
+    for (; reader.ReadRow(); ++row) {
+      timestamp = reader.GetInt(kDate);
+      close = reader.GetDouble(kClose);
+      weight = reader.GetDouble(kWeight);
+
+      if (row == 0) {
+        origin = timestamp;
+        chunk.SetOrigin(timestamp);
+        bounds.SetOrigin(timestamp);
+        bounds.PushBack(timestamp, close, weight);
+      } else if (detect && resolution > 0 &&
+                 (timestamp - origin) % resolution != 0) {
+        ResolutionChanged err;
+        err.row = row + 1;
+        err.set_file_name(filename.c_str());
+        throw err;
+      }
+
+      chunk.PushBack(timestamp, close, weight);
+      if (chunk.Size() >= chunk_rows) flush();
+    }
+
+    if (!chunk.Empty()) flush();
+    if (bounds.Size() == 1) bounds.PushBack(timestamp, close, weight);
+    return bounds;
+  });
+}
+
+PriceSeries SeriesLoader::Parse(std::string const &filename,  //
+                                const char *begin, const char *end) {
+  auto format = CompressedSource::Detect(begin, end - begin);
+  size_t rows = PriceSeries::EstimateRows(
+      CompressedSource::EstimateBytes(end - begin, format));
+
+  if (format != CompressedSource::Format::kNone) {
+    SchemaReader<> reader(
+        PriceSchema(), filename,
+        std::make_unique<CompressedSource>(filename, begin, end, format));
+    return ReadRows(reader, rows);
+  }
+
+  SchemaReader<> reader(PriceSchema(), filename, begin, end);
+  return ReadRows(reader, rows);
+}
+
+std::vector<PriceSeries> SeriesLoader::LoadMany(
+    std::vector<std::string> const &filenames, std::vector<FileStats> *stats,
+    uint32_t io_threads) {
+  size_t count = filenames.size();
+  std::vector<PriceSeries> result(count);
+  std::vector<FileStats> file_stats(count);
+  std::vector<std::exception_ptr> errors(count);
+
+  {
+    // Declared first so it is destroyed last, the readers feed it
+    ThreadPool parse_pool;
+    ThreadPool io_pool(std::max(io_threads, 1u));
+
+    for (size_t i = 0; i < count; ++i) {
+      io_pool.AddTask([&, i] {
+        auto &file_stat = file_stats[i];
+        file_stat.filename = filenames[i];
+
+        std::shared_ptr<std::string> buffer;
+        try {
+          Timer timer;
+          buffer = std::make_shared<std::string>(ReadFile(filenames[i]));
+          file_stat.read_seconds = timer.FinishSeconds();
+          file_stat.bytes = buffer->size();
+        } catch (...) {
+          errors[i] = std::current_exception();
+          return;
+        }
+
+        parse_pool.AddTask([&, i, buffer] {
+          try {
+            Timer timer;
+            const char *data = buffer->data();
+            result[i] = Parse(filenames[i], data, data + buffer->size());
+            file_stats[i].parse_seconds = timer.FinishSeconds();
+            file_stats[i].rows = result[i].Size();
+          } catch (...) {
+            errors[i] = std::current_exception();
+          }
+        });
+      });
+    }
+
+    io_pool.WaitAll();
+    parse_pool.WaitAll();
+  }
+
+  for (auto &error : errors)
+    if (error) std::rethrow_exception(error);
+
+  if (stats) *stats = std::move(file_stats);
+  return result;
+}
+
+std::string SeriesLoader::Symbol(std::string const &filename) {
+  std::string name = std::filesystem::path(filename).filename().string();
+  if (size_t suffix = CsvSuffix(name); suffix < name.size())
+    name.resize(name.size() - suffix);
+  return name;
+}
+
+std::vector<std::string> SeriesLoader::Expand(std::string const &pattern) {
+  namespace fs = std::filesystem;
+  std::vector<std::string> filenames;
+
+  if (fs::is_directory(pattern)) {
+    for (auto const &entry : fs::directory_iterator(pattern))
+      if (entry.is_regular_file() && IsCsv(entry.path().string()))
+        filenames.push_back(entry.path().string());
+  } else {
+    glob_t matches{};
+    if (::glob(pattern.c_str(), 0, nullptr, &matches) == 0)
+      for (size_t i = 0; i < matches.gl_pathc; ++i)
+        filenames.emplace_back(matches.gl_pathv[i]);
+    ::globfree(&matches);
+  }
+
+  std::sort(filenames.begin(), filenames.end());
+  return filenames;
+}
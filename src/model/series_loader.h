@@ -0,0 +1,76 @@
+#ifndef SRC_MODEL_SERIES_LOADER_H_
+#define SRC_MODEL_SERIES_LOADER_H_
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "csv.h"
+#include "price_series.h"
+
+class SeriesLoader {
+ public:
+  struct FileStats {
+    std::string filename;
+    size_t bytes = 0, rows = 0;
+    double read_seconds = 0, parse_seconds = 0;
+
+    double MegabytesPerSecond() const;
+    double RowsPerSecond() const;
+  };
+
+  // Parses the Date, Close and optional Weight columns of a csv file, other
+  // columns such as Open/High/Low/Volume are skipped unconverted. Gzip and
+  // zstd files are inflated while parsing. Dates may carry a time of day,
+  // keys then count the coarsest unit that keeps every row on its own key.
+  // Throws io::error on bad input
+  static PriceSeries Load(std::string const& filename);
+  static PriceSeries Parse(std::string const& filename,  //
+                           const char* begin, const char* end);
+
+  // Raised by Stream when a row lies off the key unit it took from the
+  // first chunk, its key would share a unit with its neighbours
+  struct ResolutionChanged : io::error::base, io::error::with_file_name {
+    size_t row = 0;
+
+    void format_error_message() const override {
+      std::snprintf(error_message_buffer, sizeof(error_message_buffer),
+                    "Row %zu of file \"%s\" is finer than the key unit of "
+                    "the rows before it.",
+                    row, file_name);
+    }
+  };
+
+  // Reads the file in chunks of up to chunk_rows rows and hands each to func,
+  // so files larger than memory can be processed in one pass. Keys count
+  // resolution units from the first row across all chunks. Returns the
+  // first and last rows, which are enough to place a fitted curve.
+  //
+  // A resolution of 0 takes the coarsest unit of the first chunk, as Load
+  // does for the whole file, and throws ResolutionChanged for a later row
+  // off that unit rather than give it a colliding key.
+  using ChunkFunc = std::function<void(SeriesView const&)>;
+  static PriceSeries Stream(std::string const& filename,
+                            ChunkFunc const& func,  //
+                            int64_t resolution = 0,
+                            size_t chunk_rows = 1 << 16);
+
+  // Reads files on io_threads workers and parses them on a separate pool
+  // sized to the hardware, so slow storage never stalls the parsers and
+  // the number of concurrent reads stays bounded
+  static std::vector<PriceSeries> LoadMany(
+      std::vector<std::string> const& filenames,
+      std::vector<FileStats>* stats = nullptr,  //
+      uint32_t io_threads = 4);
+
+  // Expands a directory into its csv files (plain, .csv.gz or .csv.zst) or a
+  // shell glob into matches
+  static std::vector<std::string> Expand(std::string const& pattern);
+
+  // File name without its directory and csv suffix, so AAPL.csv and
+  // AAPL.csv.gz both name the symbol AAPL
+  static std::string Symbol(std::string const& filename);
+};
+
+#endif  // SRC_MODEL_SERIES_LOADER_H_
@@ -41,15 +41,29 @@
 #include <vector>
 #ifndef CSV_IO_NO_THREAD
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <thread>
 #endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#endif
 #include <cassert>
 #include <cerrno>
 #include <istream>
 #include <limits>
 #include <memory>
 
+// Size of the blocks the LineReader works on, also the maximum line length
+#ifndef CSV_IO_BLOCK_LEN
+#define CSV_IO_BLOCK_LEN (1 << 20)
+#endif
+
+// Number of blocks the asynchronous reader keeps read ahead of the parser
+#ifndef CSV_IO_PREFETCH_BLOCKS
+#define CSV_IO_PREFETCH_BLOCKS 4
+#endif
+
 namespace io {
 ////////////////////////////////////////////////////////////////////////////
 //                                 LineReader                             //
@@ -137,6 +151,15 @@ class OwningStdIOByteSourceBase : public ByteSourceBase {
   explicit OwningStdIOByteSourceBase(FILE *file) : file(file) {
     // Tell the std library that we want to do the buffering ourself.
     std::setvbuf(file, 0, _IONBF, 0);
+
+    // The file is read front to back exactly once, let the kernel use a
+    // larger read-ahead window. This only affects read-ahead, pages already
+    // read stay in the page cache.
+#if defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#elif defined(F_RDAHEAD)
+    fcntl(fileno(file), F_RDAHEAD, 1);
+#endif
   }
 
   int read(char *buffer, int size) { return std::fread(buffer, 1, size, file); }
@@ -185,52 +208,87 @@ class NonOwningStringByteSource : public ByteSourceBase {
 };
 
 #ifndef CSV_IO_NO_THREAD
+// Reads up to CSV_IO_PREFETCH_BLOCKS blocks ahead on a worker thread. The
+// consumer hands out one destination buffer at a time as before, and gets
+// an already filled block copied into it as long as the disk keeps up.
 class AsynchronousReader {
  public:
-  void init(std::unique_ptr<ByteSourceBase> arg_byte_source) {
+  void init(std::unique_ptr<ByteSourceBase> arg_byte_source,
+            int arg_block_len) {
     std::unique_lock<std::mutex> guard(lock);
     byte_source = std::move(arg_byte_source);
-    desired_byte_count = -1;
+    block_len = arg_block_len;
+    for (auto &block : blocks) block.data.reset(new char[block_len]);
+    head = 0;
+    filled = 0;
+    end_of_file = false;
     termination_requested = false;
     worker = std::thread([&] {
-      std::unique_lock<std::mutex> guard(lock);
       try {
         for (;;) {
-          read_requested_condition.wait(guard, [&] {
-            return desired_byte_count != -1 || termination_requested;
-          });
-          if (termination_requested) return;
-
-          read_byte_count = byte_source->read(buffer, desired_byte_count);
-          desired_byte_count = -1;
-          if (read_byte_count == 0) break;
-          read_finished_condition.notify_one();
+          int slot;
+          {
+            std::unique_lock<std::mutex> guard(lock);
+            slot_freed_condition.wait(guard, [&] {
+              return filled < block_count || termination_requested;
+            });
+            if (termination_requested) return;
+            slot = (head + filled) % block_count;
+          }
+
+          // Only this thread touches the slot until it is counted as filled
+          int read_byte_count =
+              byte_source->read(blocks[slot].data.get(), block_len);
+
+          {
+            std::unique_lock<std::mutex> guard(lock);
+            blocks[slot].size = read_byte_count;
+            ++filled;
+            end_of_file = read_byte_count == 0;
+          }
+          block_filled_condition.notify_one();
+          if (read_byte_count == 0) return;
         }
       } catch (...) {
+        std::unique_lock<std::mutex> guard(lock);
         read_error = std::current_exception();
       }
-      read_finished_condition.notify_one();
+      block_filled_condition.notify_one();
     });
   }
 
   bool is_valid() const { return byte_source != nullptr; }
 
   void start_read(char *arg_buffer, int arg_desired_byte_count) {
-    std::unique_lock<std::mutex> guard(lock);
     buffer = arg_buffer;
     desired_byte_count = arg_desired_byte_count;
-    read_byte_count = -1;
-    read_requested_condition.notify_one();
   }
 
   int finish_read() {
-    std::unique_lock<std::mutex> guard(lock);
-    read_finished_condition.wait(
-        guard, [&] { return read_byte_count != -1 || read_error; });
-    if (read_error)
-      std::rethrow_exception(read_error);
-    else
-      return read_byte_count;
+    int slot;
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      block_filled_condition.wait(
+          guard, [&] { return filled > 0 || end_of_file || read_error; });
+      if (filled == 0) {
+        if (read_error) std::rethrow_exception(read_error);
+        return 0;
+      }
+      slot = head;
+    }
+
+    // The head slot belongs to the consumer until head moves past it
+    int read_byte_count = blocks[slot].size;
+    assert(read_byte_count <= desired_byte_count);
+    std::memcpy(buffer, blocks[slot].data.get(), read_byte_count);
+
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      head = (head + 1) % block_count;
+      --filled;
+    }
+    slot_freed_condition.notify_one();
+    return read_byte_count;
   }
 
   ~AsynchronousReader() {
@@ -239,31 +297,43 @@ class AsynchronousReader {
         std::unique_lock<std::mutex> guard(lock);
         termination_requested = true;
       }
-      read_requested_condition.notify_one();
+      slot_freed_condition.notify_one();
       worker.join();
     }
   }
 
  private:
+  static const int block_count = CSV_IO_PREFETCH_BLOCKS;
+
+  struct Block {
+    std::unique_ptr<char[]> data;
+    int size = 0;
+  };
+
   std::unique_ptr<ByteSourceBase> byte_source;
 
   std::thread worker;
 
+  Block blocks[block_count];
+  int block_len;
+  int head;
+  int filled;
+  bool end_of_file;
+
   bool termination_requested;
   std::exception_ptr read_error;
   char *buffer;
   int desired_byte_count;
-  int read_byte_count;
 
   std::mutex lock;
-  std::condition_variable read_finished_condition;
-  std::condition_variable read_requested_condition;
+  std::condition_variable block_filled_condition;
+  std::condition_variable slot_freed_condition;
 };
 #endif
 
 class SynchronousReader {
  public:
-  void init(std::unique_ptr<ByteSourceBase> arg_byte_source) {
+  void init(std::unique_ptr<ByteSourceBase> arg_byte_source, int) {
     byte_source = std::move(arg_byte_source);
   }
 
@@ -285,7 +355,7 @@ class SynchronousReader {
 
 class LineReader {
  private:
-  static const int block_len = 1 << 20;
+  static const int block_len = CSV_IO_BLOCK_LEN;
   std::unique_ptr<char[]> buffer;  // must be constructed before (and thus
                                    // destructed after) the reader!
 #ifdef CSV_IO_NO_THREAD
@@ -328,7 +398,7 @@ class LineReader {
       data_begin = 3;
 
     if (data_end == 2 * block_len) {
-      reader.init(std::move(byte_source));
+      reader.init(std::move(byte_source), block_len);
       reader.start_read(buffer.get() + 2 * block_len, block_len);
     }
   }
@@ -468,6 +538,152 @@ class LineReader {
   }
 };
 
+#ifndef CSV_IO_NO_THREAD
+// Drop-in replacement for LineReader that splits lines on a worker thread.
+// Lines are copied into batches, so the thread calling next_line only
+// tokenizes and converts columns while the next batch is being split.
+class PipelinedLineReader {
+ public:
+  PipelinedLineReader() = delete;
+  PipelinedLineReader(const PipelinedLineReader &) = delete;
+  PipelinedLineReader &operator=(const PipelinedLineReader &) = delete;
+
+  template <class... Args>
+  explicit PipelinedLineReader(Args &&...args)
+      : reader(std::forward<Args>(args)...) {
+    worker = std::thread([&] { split_lines(); });
+  }
+
+  ~PipelinedLineReader() {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      termination_requested = true;
+    }
+    batch_consumed_condition.notify_one();
+    worker.join();
+  }
+
+  void set_file_name(const std::string &file_name) {
+    reader.set_file_name(file_name);
+  }
+
+  void set_file_name(const char *file_name) { reader.set_file_name(file_name); }
+
+  const char *get_truncated_file_name() const {
+    return reader.get_truncated_file_name();
+  }
+
+  void set_file_line(unsigned file_line) {
+    line_offset = file_line - current_file_line();
+  }
+
+  unsigned get_file_line() const { return current_file_line() + line_offset; }
+
+  char *next_line() {
+    while (current_line == current.line_begin.size())
+      if (!pop_batch()) return nullptr;
+    return current.text.data() + current.line_begin[current_line++];
+  }
+
+ private:
+  static const std::size_t batch_len = 1 << 16;
+  static const std::size_t max_batches = 4;
+
+  struct Batch {
+    std::vector<char> text;
+    std::vector<std::size_t> line_begin;
+    unsigned first_line = 1;
+  };
+
+  LineReader reader;
+  std::thread worker;
+
+  Batch current;
+  std::size_t current_line = 0;
+  unsigned line_offset = 0;
+
+  std::deque<Batch> ready, spare;
+  bool end_of_file = false;
+  bool termination_requested = false;
+  std::exception_ptr read_error;
+
+  std::mutex lock;
+  std::condition_variable batch_ready_condition;
+  std::condition_variable batch_consumed_condition;
+
+  unsigned current_file_line() const {
+    return current.first_line + current_line - 1;
+  }
+
+  void split_lines() {
+    try {
+      for (bool done = false; !done;) {
+        Batch batch;
+        {
+          std::unique_lock<std::mutex> guard(lock);
+          if (!spare.empty()) {
+            batch = std::move(spare.front());
+            spare.pop_front();
+          }
+        }
+        batch.text.clear();
+        batch.line_begin.clear();
+        batch.first_line = reader.get_file_line() + 1;
+
+        while (batch.text.size() < batch_len) {
+          char *line = reader.next_line();
+          if (line == nullptr) {
+            done = true;
+            break;
+          }
+          batch.line_begin.push_back(batch.text.size());
+          batch.text.insert(batch.text.end(), line,
+                            line + std::strlen(line) + 1);
+        }
+
+        std::unique_lock<std::mutex> guard(lock);
+        batch_consumed_condition.wait(guard, [&] {
+          return ready.size() < max_batches || termination_requested;
+        });
+        if (termination_requested) return;
+        ready.push_back(std::move(batch));
+        end_of_file = done;
+        guard.unlock();
+        batch_ready_condition.notify_one();
+      }
+    } catch (...) {
+      std::unique_lock<std::mutex> guard(lock);
+      read_error = std::current_exception();
+    }
+    batch_ready_condition.notify_one();
+  }
+
+  bool pop_batch() {
+    std::unique_lock<std::mutex> guard(lock);
+    unsigned next_first_line = current_file_line() + 1;
+    if (spare.size() < max_batches && current.text.capacity() != 0)
+      spare.push_back(std::move(current));
+    current = Batch();
+    current.first_line = next_first_line;
+    current_line = 0;
+
+    batch_ready_condition.wait(
+        guard, [&] { return !ready.empty() || end_of_file || read_error; });
+    if (ready.empty()) {
+      if (read_error) std::rethrow_exception(read_error);
+      return false;
+    }
+
+    current = std::move(ready.front());
+    current_line = 0;
+    ready.pop_front();
+    guard.unlock();
+    batch_consumed_condition.notify_one();
+    return true;
+  }
+};
+#endif
+
 ////////////////////////////////////////////////////////////////////////////
 //                                 CSV                                    //
 ////////////////////////////////////////////////////////////////////////////
@@ -1067,10 +1283,11 @@ void parse(char *col, T &x) {
 template <unsigned column_count, class trim_policy = trim_chars<' ', '\t'>,
           class quote_policy = no_quote_escape<','>,
           class overflow_policy = throw_on_overflow,
-          class comment_policy = no_comment>
+          class comment_policy = no_comment,
+          class line_reader = LineReader>
 class CSVReader {
  private:
-  LineReader in;
+  line_reader in;
 
   char *row[column_count];
   std::string column_names[column_count];
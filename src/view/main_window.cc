@@ -2,7 +2,12 @@
 
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QScreen>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
+#include "timer.h"
 #include "ui_main_window.h"
 
 MainWindow::MainWindow(Controller* controller)
@@ -14,6 +19,16 @@ MainWindow::MainWindow(Controller* controller)
   points_spin_boxes_ = {ui_->interpolation_points_spin_box,
                         ui_->approximation_points_spin_box,
                         ui_->research_points_spin_box};
+  interpolation_buttons_ = {ui_->interpolation_newton_plot_button,
+                            ui_->interpolation_spline_plot_button,
+                            ui_->interpolation_barycentric_plot_button,
+                            ui_->interpolation_pchip_plot_button,
+                            ui_->interpolation_akima_plot_button};
+  approximation_buttons_ = {ui_->approximation_plot_button,
+                            ui_->smoothing_plot_button,
+                            ui_->chebyshev_plot_button,
+                            ui_->indicator_plot_button,
+                            ui_->backtest_plot_button};
 
   SetupPlots();
 }
@@ -21,41 +36,116 @@ MainWindow::MainWindow(Controller* controller)
 MainWindow::~MainWindow() { delete ui_; }
 
 void MainWindow::OnActionOpenTriggered() {
-  QString filename = QFileDialog::getOpenFileName(this, "Open File", "~/",
-                                                  "Text files (*.csv)");
+  QString filename = QFileDialog::getOpenFileName(
+      this, "Open File", "~/", "Text files (*.csv *.csv.gz *.csv.zst)");
 
   if (filename.isEmpty()) return;
 
-  QVector<double> keys, values;
+  PriceSeries const* series = nullptr;
   try {
-    std::tie(keys, values) = controller_->OpenFile(filename);
+    series = &controller_->OpenFile(filename);
   } catch (...) {
     QMessageBox::critical(this, "Error occured", "Could not open file");
     return;
   }
 
-  if (keys.empty() || values.empty()) return;
+  if (series->Empty()) return;
 
   for (auto spin_box : points_spin_boxes_) {
-    spin_box->setMinimum(values.size());
-    spin_box->setValue(values.size());
+    spin_box->setMinimum(series->Size());
+    spin_box->setValue(series->Size());
   }
 
   for (auto plot : plots_) {
     plot->Clear();
     if (plot == plots_.back()) break;
     plot->AddGraph("Origin", QCPScatterStyle::ssCircle);
-    plot->graph()->setData(keys, values);
+    plot->SetData(series->Dates(), series->Values());
     plot->RescaleAndReplot();
   }
 
-  ui_->interpolation_spline_plot_button->setEnabled(true);
-  ui_->interpolation_newton_plot_button->setEnabled(true);
-  ui_->approximation_plot_button->setEnabled(true);
+  for (auto button : interpolation_buttons_) button->setEnabled(true);
+  for (auto button : approximation_buttons_) button->setEnabled(true);
 
   setWindowTitle(filename.section("/", -1) + " - " + "Algorithmic Trading");
 }
 
+void MainWindow::OnActionOpenFolderTriggered() {
+  QString dirname =
+      QFileDialog::getExistingDirectory(this, "Open Folder", "~/");
+
+  if (dirname.isEmpty()) return;
+
+  Portfolio const* portfolio = nullptr;
+  try {
+    portfolio = &controller_->OpenFiles(dirname);
+  } catch (...) {
+    QMessageBox::critical(this, "Error occured", "Could not open files");
+    return;
+  }
+
+  double megabytes = 0, rows = 0, seconds = portfolio->LoadSeconds();
+  for (auto const& stats : portfolio->Stats()) {
+    megabytes += stats.bytes / double(1 << 20);
+    rows += stats.rows;
+  }
+
+  QString result = "Symbols: " + QString::number(portfolio->Size()) +
+                   "\nRows: " + QString::number(rows) +
+                   "\nSize: " + QString::number(megabytes) + " MB" +
+                   "\nTime: " + QString::number(seconds) + " s";
+
+  // An empty folder or a load below the clock resolution takes no time
+  if (seconds > 0)
+    result += "\nThroughput: " + QString::number(megabytes / seconds) +
+              " MB/s, " + QString::number(rows / seconds) + " rows/s";
+  QMessageBox::information(this, "Load result", result);
+}
+
+void MainWindow::OnActionApproximateFileTriggered() {
+  // The action stays enabled when the plot is full, unlike the buttons
+  if (ui_->approximation_plot->graphCount() >= 6) {
+    QMessageBox::warning(this, "Too many graphs",
+                         "Clear the plot to add another graph");
+    return;
+  }
+
+  QString filename = QFileDialog::getOpenFileName(
+      this, "Approximate Large File", "~/",
+      "Text files (*.csv *.csv.gz *.csv.zst)");
+
+  if (filename.isEmpty()) return;
+
+  size_t points = ui_->approximation_points_spin_box->value();
+  size_t degree = ui_->approximation_degree_spin_box->value();
+  size_t days = ui_->period_spin_box->value();
+
+  PlotApproximation("Streamed, degree: " + QString::number(degree), [&] {
+    return controller_->ApproximateFile(filename, points, degree, days);
+  });
+}
+
+void MainWindow::OnActionExportTriggered() {
+  QString filename = QFileDialog::getSaveFileName(
+      this, "Export", "~/", "Columnar files (*.atcol)");
+
+  if (filename.isEmpty()) return;
+
+  // Curves are named after their plot so research and fits stay apart
+  Model::Curves curves;
+  for (auto plot : plots_)
+    for (auto& [name, data] : plot->Curves())
+      curves.emplace_back((plot->objectName() + "/" + name).toStdString(),
+                          data);
+
+  try {
+    controller_->Export(filename, curves,
+                        ui_->approximation_degree_spin_box->value());
+  } catch (...) {
+    QMessageBox::critical(this, "Error occured", "Could not export");
+  }
+}
+
 void MainWindow::OnActionClearTriggered() {
   int current_tab = ui_->tabWidget->currentIndex();
 
@@ -63,12 +153,11 @@ void MainWindow::OnActionClearTriggered() {
 
   if (current_tab == 0) {
     plot->DeleteGraphsExceptFirst();
-    ui_->interpolation_newton_plot_button->setEnabled(true);
-    ui_->interpolation_spline_plot_button->setEnabled(true);
+    for (auto button : interpolation_buttons_) button->setEnabled(true);
 
   } else if (current_tab == 1) {
     plot->DeleteGraphsExceptFirst();
-    ui_->approximation_plot_button->setEnabled(true);
+    for (auto button : approximation_buttons_) button->setEnabled(true);
 
   } else {
     plot->Clear();
@@ -81,88 +170,217 @@ void MainWindow::OnInterpolationNewtonPlotButtonClicked() {
   size_t points = ui_->interpolation_points_spin_box->value();
   size_t degree = ui_->interpolation_degree_spin_box->value();
 
-  QVector<double> keys, values;
+  PlotInterpolation("Newton, Degree: " + QString::number(degree),
+                    [&] { return controller_->Newton(points, degree); });
+}
+
+void MainWindow::OnInterpolationSplinePlotButtonClicked() {
+  size_t points = ui_->interpolation_points_spin_box->value();
+
+  PlotInterpolation("Spline", [&] { return controller_->Spline(points); });
+}
+
+void MainWindow::OnInterpolationBarycentricPlotButtonClicked() {
+  size_t points = ui_->interpolation_points_spin_box->value();
+  size_t degree = ui_->interpolation_barycentric_degree_spin_box->value();
+
+  PlotInterpolation(
+      "Barycentric, Degree: " + QString::number(degree),
+      [&] { return controller_->Barycentric(points, degree); });
+}
+
+void MainWindow::OnInterpolationPchipPlotButtonClicked() {
+  size_t points = ui_->interpolation_points_spin_box->value();
+
+  PlotInterpolation("PCHIP", [&] { return controller_->Pchip(points); });
+}
+
+void MainWindow::OnInterpolationAkimaPlotButtonClicked() {
+  size_t points = ui_->interpolation_points_spin_box->value();
+
+  PlotInterpolation("Akima", [&] { return controller_->Akima(points); });
+}
+
+void MainWindow::OnApproximationPlotButtonClicked() {
+  static size_t s_days = ui_->period_spin_box->value();
+
+  size_t points = ui_->approximation_points_spin_box->value();
+  size_t degree = ui_->approximation_degree_spin_box->value();
+  size_t days = ui_->period_spin_box->value();
+
+  Model::GraphData data;
   try {
-    std::tie(keys, values) = controller_->Newton(points, degree);
+    data = controller_->Approximate(points, degree, days);
   } catch (...) {
     QMessageBox::critical(this, "Error occured", "Could not proceed");
     return;
   }
 
-  if (keys.empty() || values.empty()) return;
+  if (!data || data->isEmpty()) return;
 
-  auto& plot = ui_->interpolation_plot;
-  plot->AddGraph("Newton, Degree: " + QString::number(degree));
-  plot->graph()->setData(keys, values);
+  auto& plot = ui_->approximation_plot;
 
-  if (plot->graphCount() >= 6) {
-    ui_->interpolation_newton_plot_button->setEnabled(false);
-    ui_->interpolation_spline_plot_button->setEnabled(false);
+  if (days != s_days) {
+    plot->DeleteGraphsExceptFirst();
+    s_days = days;
   }
 
+  plot->AddGraph("Degree: " + QString::number(degree));
+  plot->SetData(data);
+
+  if (ui_->approximation_plot->graphCount() == 6)
+    for (auto button : approximation_buttons_) button->setEnabled(false);
+
   plot->RescaleAndReplot();
 }
 
-void MainWindow::OnInterpolationSplinePlotButtonClicked() {
-  size_t points = ui_->interpolation_points_spin_box->value();
-  QVector<double> keys, values;
+void MainWindow::OnSmoothingPlotButtonClicked() {
+  size_t points = ui_->approximation_points_spin_box->value();
+  int exponent = ui_->smoothing_lambda_spin_box->value();
+
+  PlotApproximation(
+      "Smoothing, lambda: 1e" + QString::number(exponent),
+      [&] { return controller_->Smooth(points, std::pow(10.0, exponent)); });
+}
+
+void MainWindow::OnChebyshevPlotButtonClicked() {
+  size_t points = ui_->approximation_points_spin_box->value();
+  size_t degree = ui_->chebyshev_degree_spin_box->value();
+  size_t days = ui_->period_spin_box->value();
+
+  PlotApproximation(
+      "Chebyshev, degree: " + QString::number(degree),
+      [&] { return controller_->Chebyshev(points, degree, days); });
+}
+
+void MainWindow::OnIndicatorPlotButtonClicked() {
+  // Combo box entries follow the order of Indicators::Kind
+  Indicators::Spec spec{
+      static_cast<Indicators::Kind>(ui_->indicator_combo_box->currentIndex()),
+      static_cast<size_t>(ui_->indicator_period_spin_box->value())};
+
+  Model::Curves curves;
   try {
-    std::tie(keys, values) = controller_->Spline(points);
+    curves = controller_->CalcIndicators({spec});
   } catch (...) {
     QMessageBox::critical(this, "Error occured", "Could not proceed");
     return;
   }
 
-  if (keys.empty() || values.empty()) return;
+  if (curves.empty()) return;
 
-  auto& plot = ui_->interpolation_plot;
-  plot->AddGraph("Spline");
-  plot->graph()->setData(keys, values);
+  auto& plot = ui_->approximation_plot;
+  if (plot->graphCount() + curves.size() > 6) {
+    QMessageBox::warning(this, "Too many graphs",
+                         "Clear the plot to add this indicator");
+    return;
+  }
 
-  if (plot->graphCount() >= 6) {
-    ui_->interpolation_newton_plot_button->setEnabled(false);
-    ui_->interpolation_spline_plot_button->setEnabled(false);
+  for (auto& [name, data] : curves) {
+    plot->AddGraph(QString::fromStdString(name), QCPScatterStyle::ssNone,
+                   spec.OwnScale());
+    plot->SetData(data);
   }
 
+  if (plot->graphCount() >= 6)
+    for (auto button : approximation_buttons_) button->setEnabled(false);
+
   plot->RescaleAndReplot();
 }
 
-void MainWindow::OnApproximationPlotButtonClicked() {
-  static size_t s_days = ui_->period_spin_box->value();
-
-  size_t points = ui_->approximation_points_spin_box->value();
-  size_t degree = ui_->approximation_degree_spin_box->value();
-  size_t days = ui_->period_spin_box->value();
+void MainWindow::OnBacktestPlotButtonClicked() {
+  Backtest::Params params = BacktestParams();
 
-  QVector<double> keys, values;
+  Model::BacktestData data;
   try {
-    std::tie(keys, values) = controller_->Approximate(points, degree, days);
+    data = controller_->RunBacktest(params);
+  } catch (std::invalid_argument const& error) {
+    // Parameters the engine rejects, such as a window too short to fit
+    QMessageBox::warning(this, "Invalid parameters", error.what());
+    return;
   } catch (...) {
     QMessageBox::critical(this, "Error occured", "Could not proceed");
     return;
   }
 
-  if (keys.empty() || values.empty()) return;
+  auto& [stats, equity] = data;
+  if (!equity || equity->isEmpty()) return;
 
+  // P&L is not on the price scale
   auto& plot = ui_->approximation_plot;
+  plot->AddGraph("Backtest, degree: " + QString::number(params.degree) +
+                     ", window: " + QString::number(params.window),
+                 QCPScatterStyle::ssNone, true);
+  plot->SetData(equity);
 
-  if (days != s_days) {
-    plot->DeleteGraphsExceptFirst();
-    s_days = days;
-  }
+  if (plot->graphCount() >= 6)
+    for (auto button : approximation_buttons_) button->setEnabled(false);
 
-  plot->AddGraph("Degree: " + QString::number(degree));
-  plot->graph()->setData(keys, values);
+  plot->RescaleAndReplot();
+  QMessageBox::information(this, "Backtest result", BacktestReport(stats));
+}
 
-  if (ui_->approximation_plot->graphCount() == 6) {
-    ui_->approximation_plot_button->setEnabled(false);
+void MainWindow::OnBacktestSweepButtonClicked() {
+  // Every degree, a spread of windows and doubling horizons up to the set
+  // one, all at the set cost
+  Backtest::Params base = BacktestParams();
+  std::vector<size_t> horizons;
+  for (size_t horizon = 1; horizon < base.horizon; horizon *= 2)
+    horizons.push_back(horizon);
+  horizons.push_back(base.horizon);
+
+  std::vector<Backtest::Params> grid;
+  for (size_t degree = 0; degree <= Backtest::kMaxDegree; ++degree)
+    for (size_t window : {0, 10, 20, 50, 100, 200, 500})
+      for (size_t horizon : horizons) {
+        if (window && window < degree + 2) continue;
+        Backtest::Params params = base;
+        params.degree = degree;
+        params.window = window;
+        params.horizon = horizon;
+        grid.push_back(params);
+      }
+
+  std::vector<Backtest::Stats> results;
+  Timer timer;
+  try {
+    results = controller_->SweepBacktest(grid);
+  } catch (std::invalid_argument const& error) {
+    QMessageBox::warning(this, "Invalid parameters", error.what());
+    return;
+  } catch (...) {
+    QMessageBox::critical(this, "Error occured", "Could not proceed");
+    return;
   }
+  double seconds = timer.FinishSeconds();
 
-  plot->RescaleAndReplot();
+  if (results.empty()) return;
+
+  size_t best = std::max_element(results.begin(), results.end(),
+                                 [](auto const& lhs, auto const& rhs) {
+                                   return lhs.sharpe < rhs.sharpe;
+                                 }) -
+                results.begin();
+
+  QString result = "Runs: " + QString::number(grid.size()) +
+                   "\nTime: " + QString::number(seconds) + " s";
+
+  // A sweep over a short series can finish below the clock resolution
+  if (seconds > 0)
+    result += "\nThroughput: " + QString::number(grid.size() / seconds * 60) +
+              " runs/min";
+
+  result += "\n\nBest Sharpe at degree " + QString::number(grid[best].degree) +
+            ", window " + QString::number(grid[best].window) + ", horizon " +
+            QString::number(grid[best].horizon) + "\n" +
+            BacktestReport(results[best]);
+  QMessageBox::information(this, "Sweep result", result);
 }
 
 void MainWindow::OnInterpolationSearchButtonClicked() {
-  double date = ui_->interpolation_date_edit->dateTime().toSecsSinceEpoch();
+  double date = ui_->interpolation_date_edit->date()
+                    .startOfDay(Qt::UTC)
+                    .toSecsSinceEpoch();
   size_t degree = ui_->interpolation_degree_spin_box->value();
 
   double newton_value, spline_value;
@@ -181,7 +399,9 @@ void MainWindow::OnInterpolationSearchButtonClicked() {
 }
 
 void MainWindow::OnApproximationSearchButtonClicked() {
-  double date = ui_->approximation_date_edit->dateTime().toSecsSinceEpoch();
+  double date = ui_->approximation_date_edit->date()
+                    .startOfDay(Qt::UTC)
+                    .toSecsSinceEpoch();
   size_t degree = ui_->approximation_degree_spin_box->value();
 
   double value = 0;
@@ -201,25 +421,25 @@ void MainWindow::OnInterpolationResearchButtonClicked() {
   size_t points = ui_->research_points_spin_box->value();
   size_t partitions = ui_->research_partitions_spin_box->value();
 
-  QVector<double> keys, newton_values, spline_values;
+  Model::GraphData newton, spline;
   try {
-    std::tie(keys, newton_values, spline_values) =
+    std::tie(newton, spline) =
         controller_->InterpolationResearch(points, partitions);
   } catch (...) {
     QMessageBox::critical(this, "Error occured", "Could not open file");
     return;
   }
 
-  if (keys.empty() || newton_values.empty() || spline_values.empty()) return;
+  if (!newton || !spline || newton->isEmpty() || spline->isEmpty()) return;
 
   auto& plot = ui_->researchPlot;
   plot->Clear();
 
   plot->AddGraph("Newton research");
-  plot->graph()->setData(keys, newton_values);
+  plot->SetData(newton);
 
   plot->AddGraph("Spline research");
-  plot->graph()->setData(keys, spline_values);
+  plot->SetData(spline);
 
   plot->RescaleAndReplot();
 }
@@ -228,33 +448,32 @@ void MainWindow::OnApproximationResearchButtonClicked() {
   size_t points = ui_->approximation_points_spin_box->value();
   size_t days = ui_->period_spin_box->value();
 
-  QVector<double> keys, values1, values2, values3, values4;
+  Model::GraphData values1, values2, values3, values4;
   try {
-    std::tie(keys, values1, values2, values3, values4) =
+    std::tie(values1, values2, values3, values4) =
         controller_->ApproximationResearch(points, days);
   } catch (...) {
     QMessageBox::critical(this, "Error occured", "Could not open file");
     return;
   }
 
-  if (keys.empty() || values1.empty() || values2.empty() || values3.empty() ||
-      values4.empty())
+  if (!values1 || !values2 || !values3 || !values4 || values1->isEmpty())
     return;
 
   auto& plot = ui_->approximation_plot;
   plot->DeleteGraphsExceptFirst();
 
   plot->AddGraph("Degree: 1, Weights: user-defined");
-  plot->graph()->setData(keys, values1);
+  plot->SetData(values1);
 
   plot->AddGraph("Degree: 2, Weights: user-defined");
-  plot->graph()->setData(keys, values2);
+  plot->SetData(values2);
 
   plot->AddGraph("Degree: 1, Weights: 1");
-  plot->graph()->setData(keys, values3);
+  plot->SetData(values3);
 
   plot->AddGraph("Degree: 2, Weights: 1");
-  plot->graph()->setData(keys, values4);
+  plot->SetData(values4);
 
   plot->RescaleAndReplot();
 
@@ -263,16 +482,90 @@ void MainWindow::OnApproximationResearchButtonClicked() {
 
 void MainWindow::SetupPlots() {
   for (auto& plot : plots_) {
-    connect(plot, &QCustomPlot::mouseMove, this, &MainWindow::PlotMouseMove);
+    connect(plot, &QCustomPlot::mouseMove, this,
+            [this, plot](QMouseEvent* event) { PlotMouseMove(plot, event); });
     plot->SetAxis(plot == plots_.back() ? "Points" : "Date",
                   plot == plots_.back() ? "Time [ms]" : "Close",
                   plot != plots_.back());
   }
+
+  // Hover updates are coalesced to at most one per display frame
+  qreal refresh_rate = QGuiApplication::primaryScreen()->refreshRate();
+  hover_timer_.setSingleShot(true);
+  hover_timer_.setInterval(1000 / std::max<qreal>(refresh_rate, 1));
+  connect(&hover_timer_, &QTimer::timeout, this, &MainWindow::UpdateTracers);
 }
 
-void MainWindow::PlotMouseMove(QMouseEvent* event) {
-  for (auto plot : plots_) {
-    plot->SetTracers(event->pos(), plot != plots_.back());
-    plot->replot();
+void MainWindow::PlotMouseMove(Plot* plot, QMouseEvent* event) {
+  hovered_plot_ = plot;
+  hover_pos_ = event->pos();
+  if (!hover_timer_.isActive()) hover_timer_.start();
+}
+
+void MainWindow::UpdateTracers() {
+  if (!hovered_plot_ || !hovered_plot_->isVisible()) return;
+
+  hovered_plot_->SetTracers(hover_pos_, hovered_plot_ != plots_.back());
+  hovered_plot_->ReplotOverlay();
+}
+
+void MainWindow::PlotInterpolation(
+    QString const& name, std::function<Model::GraphData()> const& calc) {
+  Model::GraphData data;
+  try {
+    data = calc();
+  } catch (...) {
+    QMessageBox::critical(this, "Error occured", "Could not proceed");
+    return;
   }
+
+  if (!data || data->isEmpty()) return;
+
+  auto& plot = ui_->interpolation_plot;
+  plot->AddGraph(name);
+  plot->SetData(data);
+
+  if (plot->graphCount() >= 6)
+    for (auto button : interpolation_buttons_) button->setEnabled(false);
+
+  plot->RescaleAndReplot();
+}
+
+void MainWindow::PlotApproximation(
+    QString const& name, std::function<Model::GraphData()> const& calc) {
+  Model::GraphData data;
+  try {
+    data = calc();
+  } catch (...) {
+    QMessageBox::critical(this, "Error occured", "Could not proceed");
+    return;
+  }
+
+  if (!data || data->isEmpty()) return;
+
+  auto& plot = ui_->approximation_plot;
+  plot->AddGraph(name);
+  plot->SetData(data);
+
+  if (plot->graphCount() >= 6)
+    for (auto button : approximation_buttons_) button->setEnabled(false);
+
+  plot->RescaleAndReplot();
+}
+
+Backtest::Params MainWindow::BacktestParams() const {
+  Backtest::Params params;
+  params.degree = ui_->backtest_degree_spin_box->value();
+  params.window = ui_->backtest_window_spin_box->value();
+  params.horizon = ui_->backtest_horizon_spin_box->value();
+  params.cost = ui_->backtest_cost_spin_box->value() / 1e4;
+  return params;
+}
+
+QString MainWindow::BacktestReport(Backtest::Stats const& stats) {
+  return "P&L: " + QString::number(stats.pnl) +
+         "\nMax drawdown: " + QString::number(stats.max_drawdown) +
+         "\nSharpe per bar: " + QString::number(stats.sharpe) +
+         "\nTrades: " + QString::number(stats.trades) +
+         "\nBars in market: " + QString::number(stats.bars_in_market);
 }
@@ -2,6 +2,8 @@
 #define SRC_VIEW_MAIN_WINDOW_H_
 
 #include <QMainWindow>
+#include <QTimer>
+#include <functional>
 
 #include "controller.h"
 #include "plot.h"
@@ -23,12 +25,23 @@ class MainWindow : public QMainWindow {
 
  private slots:
   void OnActionOpenTriggered();
+  void OnActionOpenFolderTriggered();
+  void OnActionApproximateFileTriggered();
+  void OnActionExportTriggered();
   void OnActionClearTriggered();
   void OnActionQuitTriggered();
 
   void OnInterpolationNewtonPlotButtonClicked();
   void OnInterpolationSplinePlotButtonClicked();
+  void OnInterpolationBarycentricPlotButtonClicked();
+  void OnInterpolationPchipPlotButtonClicked();
+  void OnInterpolationAkimaPlotButtonClicked();
   void OnApproximationPlotButtonClicked();
+  void OnSmoothingPlotButtonClicked();
+  void OnChebyshevPlotButtonClicked();
+  void OnIndicatorPlotButtonClicked();
+  void OnBacktestPlotButtonClicked();
+  void OnBacktestSweepButtonClicked();
 
   void OnInterpolationSearchButtonClicked();
   void OnApproximationSearchButtonClicked();
@@ -41,9 +54,23 @@ class MainWindow : public QMainWindow {
   Controller *controller_;
   QList<Plot *> plots_;
   QList<QSpinBox *> points_spin_boxes_;
+  QList<QPushButton *> interpolation_buttons_;
+  QList<QPushButton *> approximation_buttons_;
+
+  QTimer hover_timer_;
+  Plot *hovered_plot_ = nullptr;
+  QPoint hover_pos_;
 
   void SetupPlots();
-  void PlotMouseMove(QMouseEvent *event);
+  void PlotMouseMove(Plot *plot, QMouseEvent *event);
+  void UpdateTracers();
+  void PlotInterpolation(QString const &name,
+                         std::function<Model::GraphData()> const &calc);
+  void PlotApproximation(QString const &name,
+                         std::function<Model::GraphData()> const &calc);
+  Backtest::Params BacktestParams() const;
+
+  static QString BacktestReport(Backtest::Stats const &stats);
 };
 
 #endif  // SRC_VIEW_MAIN_WINDOW_H_
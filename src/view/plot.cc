@@ -1,11 +1,19 @@
 #include "plot.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "date.h"
+
 Plot::Plot(QWidget *parent) : QCustomPlot(parent) {
   setInteractions({QCP::iRangeDrag, QCP::iRangeZoom, QCP::iSelectPlottables});
   axisRect()->setAutoMargins({QCP::msBottom, QCP::msLeft});
   axisRect()->setMargins(QMargins{50, 50, 50, 50});
   axisRect()->insetLayout()->setInsetAlignment(0, Qt::AlignLeft | Qt::AlignTop);
   legend->setVisible(true);
+
+  connect(this, &QCustomPlot::beforeReplot, this, &Plot::UpdateDecimation);
 }
 
 Plot::~Plot() { Clear(); }
@@ -18,49 +26,120 @@ void Plot::SetAxis(QString const &x_axis, QString const &y_axis, bool to_date) {
 
   QSharedPointer<QCPAxisTickerDateTime> date_ticker(new QCPAxisTickerDateTime);
   date_ticker->setDateTimeFormat("yyyy-MM-dd");
+  date_ticker->setDateTimeSpec(Qt::UTC);
   xAxis->setTicker(date_ticker);
   xAxis->setTickLabelRotation(-45);
+
+  // Intraday series need the time of day once zoomed in past a few days
+  connect(xAxis, QOverload<QCPRange const &>::of(&QCPAxis::rangeChanged), this,
+          [date_ticker](QCPRange const &range) {
+            bool intraday = range.size() < 3 * Date::kSecondsPerDay;
+            date_ticker->setDateTimeFormat(intraday ? "yyyy-MM-dd\nhh:mm"
+                                                    : "yyyy-MM-dd");
+          });
+}
+
+void Plot::SetData(GraphData const &data) {
+  // Short series are cheap enough to hand to QCustomPlot as they are
+  constexpr int kDecimationThreshold = 1 << 14;
+
+  decimators_.erase(graph());
+  if (data->size() <= kDecimationThreshold) {
+    graph()->setData(data);
+    return;
+  }
+
+  auto &decimator = decimators_.emplace(graph(), Decimator(data)).first->second;
+  decimator.Update(xAxis->range(), axisRect()->width());
+  graph()->setData(decimator.Output());
+}
+
+void Plot::SetData(Span<const double> keys, Span<const double> values) {
+  // Keys come from an already sorted series, so fill QCustomPlot's storage
+  // directly and skip both the QVector round-trip and the sort pass
+  QVector<QCPGraphData> data(std::min(keys.size(), values.size()));
+  for (int i = 0; i < data.size(); ++i) data[i] = {keys[i], values[i]};
+
+  GraphData graph_data(new QCPGraphDataContainer);
+  graph_data->set(data, true);
+  SetData(graph_data);
+}
+
+void Plot::RescaleAndReplot() {
+  // Decimated graphs only hold the range visible when their data was set,
+  // so rescaleAxes() would fit that, the sources give the true extents
+  std::map<QCPAxis *, QCPRange> ranges;
+  auto extend = [&](QCPAxis *axis, QCPRange const &range) {
+    auto [itr, added] = ranges.emplace(axis, range);
+    if (!added) itr->second.expand(range);
+  };
+
+  for (int i = 0; i < graphCount(); ++i) {
+    GraphData data = GetSourceData(graph(i));
+    bool found_keys = false, found_values = false;
+    QCPRange keys = data->keyRange(found_keys);
+    QCPRange values = data->valueRange(found_values);
+    if (found_keys) extend(graph(i)->keyAxis(), keys);
+    if (found_values) extend(graph(i)->valueAxis(), values);
+  }
+
+  // A single point keeps the axis span and centers on it, like rescale()
+  for (auto &[axis, range] : ranges) {
+    if (range.size() > 0)
+      axis->setRange(range);
+    else
+      axis->setRange(range.lower, axis->range().size(), Qt::AlignCenter);
+  }
+
+  replot();
 }
 
 void Plot::SetTracers(QPoint const &pos, bool to_date) {
+  constexpr double kLabelSpacing = 30;
   double x = xAxis->pixelToCoord(pos.x());
 
-  std::vector<size_t> y_coords;
-  y_coords.reserve(6);
+  std::vector<std::pair<double, QCPItemLine *>> arrows;
+  arrows.reserve(attributes_.size());
 
-  auto GetShift = [&y_coords](double y) -> int {
-    int shift = -30;
-    for (auto &i : y_coords)
-      while ((i - 30 <= y + shift) && (y + shift <= i + 30)) --shift;
+  for (auto &[graph, attributes] : attributes_) {
+    auto &[tracer, arrow, label] = attributes;
+    GraphData data = GetSourceData(graph);
+    if (data->isEmpty()) continue;
 
-    y_coords.push_back(y + shift);
-    return shift;
-  };
+    auto itr = FindNearest(*data, x);
+    tracer->position->setCoords(itr->key, itr->value);
 
-  for (auto &i : attributes_) {
-    auto &[tracer, arrow, label] = i.second;
-    tracer->setGraphKey(x);
-    tracer->updatePosition();
-    auto [x_coord, y_coord] = tracer->position->coords();
+    bool midnight = std::fmod(itr->key, Date::kSecondsPerDay) == 0;
     QString x_info = to_date
-                         ? QCPAxisTickerDateTime::keyToDateTime(x_coord).  //
-                           toString("yyyy-MM-dd")
-                         : QString::number(x_coord);
+                         ? QCPAxisTickerDateTime::keyToDateTime(itr->key)
+                               .toUTC()
+                               .toString(midnight ? "yyyy-MM-dd"
+                                                  : "yyyy-MM-dd hh:mm:ss")
+                         : QString::number(itr->key);
+
+    label->setText(x_info + "\n" + QString::number(itr->value));
+    arrows.emplace_back(tracer->position->pixelPosition().y(), arrow);
+  }
 
-    label->setText(x_info + "\n" + QString::number(y_coord));
-    label->setLayer("overlay");
+  // Stack labels upwards starting from the lowest tracer on screen
+  std::sort(arrows.begin(), arrows.end(), std::greater<>());
 
-    arrow->start->setCoords(0, GetShift(tracer->position->pixelPosition().y()));
+  double top = std::numeric_limits<double>::max();
+  for (auto &[y, arrow] : arrows) {
+    top = std::min(y, top) - kLabelSpacing;
+    arrow->start->setCoords(0, top - y);
   }
 }
 
 void Plot::AddGraph(QString const &name,
-                    QCPScatterStyle::ScatterShape scatter_shape) {
+                    QCPScatterStyle::ScatterShape scatter_shape,
+                    bool secondary_axis) {
   static const QVector<QColor> colors = {Qt::blue,  Qt::red,  Qt::darkYellow,
                                          Qt::green, Qt::cyan, Qt::magenta};
   QColor color = colors.at(graphCount());
 
-  addGraph();
+  addGraph(xAxis, secondary_axis ? yAxis2 : yAxis);
+  if (secondary_axis) yAxis2->setVisible(true);
   graph()->setName(name);
   graph()->setPen(QPen(color));
   SetGraph(graph(), color);
@@ -83,13 +162,17 @@ void Plot::Clear() {
   }
 
   attributes_.clear();
+  decimators_.clear();
   clearGraphs();
+  yAxis2->setVisible(false);
 }
 
 void Plot::SetGraph(QCPGraph *graph, QColor const &color) {
+  // Positioned by SetTracers against the full resolution data, since the
+  // graph itself may only hold a decimated copy
   auto tracer = new QCPItemTracer(this);
+  tracer->position->setAxes(graph->keyAxis(), graph->valueAxis());
   tracer->setVisible(false);
-  tracer->setGraph(graph);
 
   auto arrow = new QCPItemLine(this);
   arrow->end->setParentAnchor(tracer->position);
@@ -123,5 +206,101 @@ void Plot::DeleteGraph(QCPGraph *graph) {
   removeItem(label);
 
   attributes_.erase(itr);
+  decimators_.erase(graph);
   removeGraph(graph);
+  if (yAxis2->graphs().isEmpty()) yAxis2->setVisible(false);
+}
+
+std::vector<std::pair<QString, Plot::GraphData>> Plot::Curves() const {
+  std::vector<std::pair<QString, GraphData>> curves;
+  curves.reserve(graphCount());
+  for (int i = 0; i < graphCount(); ++i)
+    curves.emplace_back(graph(i)->name(), GetSourceData(graph(i)));
+  return curves;
+}
+
+Plot::GraphData Plot::GetSourceData(QCPGraph *graph) const {
+  auto itr = decimators_.find(graph);
+  return itr == decimators_.end() ? graph->data() : itr->second.Source();
+}
+
+QCPGraphDataContainer::const_iterator  //
+Plot::FindNearest(QCPGraphDataContainer const &data, double key) {
+  auto itr = std::lower_bound(
+      data.constBegin(), data.constEnd(), key,
+      [](QCPGraphData const &point, double x) { return point.key < x; });
+
+  if (itr == data.constEnd()) return itr - 1;
+  if (itr == data.constBegin()) return itr;
+  return (key - (itr - 1)->key < itr->key - key) ? itr - 1 : itr;
+}
+
+void Plot::UpdateDecimation() {
+  for (auto &item : decimators_)
+    item.second.Update(xAxis->range(), axisRect()->width());
+}
+
+Plot::Decimator::Decimator(GraphData source)
+    : source_(std::move(source)), output_(new QCPGraphDataContainer) {
+  BuildLevels();
+}
+
+bool Plot::Decimator::Update(QCPRange const &range, int width) {
+  width = std::max(width, 1);
+  if (range == range_ && width == width_) return false;
+  range_ = range, width_ = width;
+
+  auto const &data = *source_;
+  auto begin = data.constBegin();
+
+  // Expanded lookups keep one point beyond each edge, so lines reach it
+  int lo = data.findBegin(range.lower) - begin;
+  int hi = data.findEnd(range.upper) - begin;
+
+  size_t shift = 0;
+  while (shift < levels_.size() && ((hi - lo) >> shift) > width) ++shift;
+
+  QVector<QCPGraphData> points;
+  if (shift == 0) {
+    points.reserve(hi - lo);
+    for (int i = lo; i < hi; ++i) points.append(begin[i]);
+  } else {
+    auto const &buckets = levels_[shift - 1];
+    int first = lo >> shift;
+    int last = std::min<int>((hi - 1) >> shift, buckets.size() - 1);
+
+    points.reserve(2 * (last - first + 1));
+    for (int i = first; i <= last; ++i) {
+      auto [min, max] = buckets[i];
+      points.append(begin[std::min(min, max)]);
+      if (min != max) points.append(begin[std::max(min, max)]);
+    }
+  }
+
+  output_->set(points, true);
+  return true;
+}
+
+void Plot::Decimator::BuildLevels() {
+  auto begin = source_->constBegin();
+  int size = source_->size();
+
+  auto merge = [&](Bucket lhs, Bucket rhs) -> Bucket {
+    return {begin[rhs.min].value < begin[lhs.min].value ? rhs.min : lhs.min,
+            begin[rhs.max].value > begin[lhs.max].value ? rhs.max : lhs.max};
+  };
+
+  std::vector<Bucket> level((size + 1) / 2);
+  for (int i = 0; i < size; ++i)
+    level[i / 2] = (i % 2) ? merge(level[i / 2], {i, i}) : Bucket{i, i};
+
+  while (level.size() > 1) {
+    std::vector<Bucket> next((level.size() + 1) / 2);
+    for (size_t i = 0; i < level.size(); ++i)
+      next[i / 2] = (i % 2) ? merge(next[i / 2], level[i]) : level[i];
+
+    levels_.push_back(std::move(level));
+    level = std::move(next);
+  }
+  levels_.push_back(std::move(level));
 }
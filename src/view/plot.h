@@ -2,9 +2,12 @@
 #define SRC_VIEW_PLOT_H_
 
 #include "shared/qcustomplot.h"
+#include "span.h"
 
 class Plot : public QCustomPlot {
  public:
+  using GraphData = QSharedPointer<QCPGraphDataContainer>;
+
   Plot(QWidget* parent = nullptr);
   ~Plot();
   Plot(Plot&&) = delete;
@@ -16,21 +19,70 @@ class Plot : public QCustomPlot {
                QString const& y_axis,  //
                bool to_date = false);
 
+  // Graphs on the secondary axis get a value scale of their own on the
+  // right, for oscillators plotted over prices
   void AddGraph(QString const& name,
-                QCPScatterStyle::ScatterShape = QCPScatterStyle::ssNone);
+                QCPScatterStyle::ScatterShape = QCPScatterStyle::ssNone,
+                bool secondary_axis = false);
 
+  void SetData(GraphData const& data);
+  void SetData(Span<const double> keys, Span<const double> values);
   void SetTracers(QPoint const& pos, bool to_date = false);
-  void RescaleAndReplot() { rescaleAxes(), replot(); }
+  // Fits every axis to the full data of its graphs, then decimates anew
+  void RescaleAndReplot();
+  void ReplotOverlay() { layer("overlay")->replot(); }
   void DeleteGraphsExceptFirst();
   void Clear();
 
+  // Every graph by name with its full, undecimated data
+  std::vector<std::pair<QString, GraphData>> Curves() const;
+
  private:
   using Attributes = std::tuple<QCPItemTracer*, QCPItemLine*, QCPItemText*>;
 
+  class Decimator;
+
   std::map<QCPGraph*, Attributes> attributes_;
+  std::map<QCPGraph*, Decimator> decimators_;
 
   void SetGraph(QCPGraph* graph, QColor const& color);
   void DeleteGraph(QCPGraph* graph);
+  void UpdateDecimation();
+  GraphData GetSourceData(QCPGraph* graph) const;
+
+  static QCPGraphDataContainer::const_iterator  //
+  FindNearest(QCPGraphDataContainer const& data, double key);
+};
+
+// Level-of-detail view over a long sorted series. Keeps a pyramid of
+// per-bucket min/max indices, bucket size doubling per level, and feeds the
+// graph only the visible range at the level where one bucket spans about
+// one pixel column, so the plotted point count depends on the widget width
+// rather than on the series length.
+class Plot::Decimator {
+ public:
+  explicit Decimator(GraphData source);
+  ~Decimator() = default;
+  Decimator(Decimator&&) = default;
+  Decimator(const Decimator&) = delete;
+  Decimator& operator=(Decimator&&) = default;
+  Decimator& operator=(const Decimator&) = delete;
+
+  GraphData const& Source() const { return source_; }
+  GraphData const& Output() const { return output_; }
+  bool Update(QCPRange const& range, int width);
+
+ private:
+  struct Bucket {
+    int min, max;
+  };
+
+  GraphData source_, output_;
+  std::vector<std::vector<Bucket>> levels_;
+  QCPRange range_;
+  int width_ = 0;
+
+  void BuildLevels();
 };
 
 #endif  // SRC_VIEW_PLOT_H_